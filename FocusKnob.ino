@@ -20,6 +20,9 @@
 #include "weather_data.h"
 #include "calendar_data.h"
 #include "jira_hours_data.h"
+#include "clock_sync.h"
+#include "json_arena.h"
+#include "warm_start.h"
 
 // Encoder pins
 #define ENCODER_PIN_A    8
@@ -76,6 +79,9 @@ void setup() {
     Serial.begin(115200);
     Serial.println("Pomodoro Timer Starting...");
 
+    // JSON parse arena - time_log_init() in lcd_lvgl_Init() already needs it
+    json_arena_init();
+
     // Initialize LCD and LVGL
     lcd_lvgl_Init();
 
@@ -106,9 +112,6 @@ void setup() {
     // Initialize WiFi config system
     wifi_config_init();
 
-    // Initialize USB sync
-    usb_sync_init();
-
     // Initialize Jira data cache
     jira_data_init();
 
@@ -121,6 +124,15 @@ void setup() {
     // Initialize Jira hours data cache
     jira_hours_data_init();
 
+    // Restore the last companion data from flash (after the caches exist)
+    warm_start_init();
+
+    // Initialize clock sync (TIMESYNC/TIMEADJ)
+    clock_sync_init();
+
+    // Initialize USB sync (after data modules register their commands)
+    usb_sync_init();
+
     Serial.println("Pomodoro Timer Ready!");
 }
 
@@ -1,85 +1,241 @@
+#define LOG_TAG "CalendarData"
 #include "calendar_data.h"
+#include "debug_log.h"
+#include "usb_sync.h"
+#include "json_stream.h"
+#include "json_arena.h"
+#include "snapshot.h"
+#include "data_bus.h"
+#include "warm_start.h"
 #include <Arduino.h>
 #include <ArduinoJson.h>
 #include <string.h>
+#include <time.h>
 
-static calendar_state_t g_calendar_state;
+// Double-buffered so the LVGL task never sees a half-written update
+static calendar_state_t g_calendar_buf[2];
+static snapshot_t g_calendar_snap = SNAPSHOT_INITIALIZER(&g_calendar_buf[0], &g_calendar_buf[1]);
+
+static const calendar_state_t* calendar_live(void) {
+    return (const calendar_state_t*)snapshot_live(&g_calendar_snap);
+}
+
+static void handle_calendar_command(const char* payload);
+static void calendar_stream_begin(void);
+static void calendar_stream_feed(const char* data, size_t len);
+static void calendar_stream_end(bool complete);
+
+// CALENDAR_STREAM:<json> - same document, events stored as they arrive
+static const usb_sync_stream_t g_calendar_stream_cmd = {
+    calendar_stream_begin, calendar_stream_feed, calendar_stream_end
+};
+static json_stream_t g_calendar_stream;
+static calendar_state_t* g_stream_state = NULL;  // Back buffer being streamed into
+static uint8_t g_stream_count = 0;
 
 void calendar_data_init(void) {
-    memset(&g_calendar_state, 0, sizeof(g_calendar_state));
-    g_calendar_state.next_meeting_min = -2;
-    g_calendar_state.synced = false;
-    Serial.println("CalendarData: Initialized");
+    snapshot_init(&g_calendar_snap, &g_calendar_buf[0], &g_calendar_buf[1], sizeof(calendar_state_t));
+    g_calendar_buf[0].next_meeting_min = -2;
+    LOGI("Initialized");
+
+    usb_sync_register_command("CALENDAR", handle_calendar_command);
+    usb_sync_register_stream("CALENDAR_STREAM", &g_calendar_stream_cmd);
 }
 
-void calendar_data_set(const char* json) {
-    StaticJsonDocument<4096> doc;
-    DeserializationError err = deserializeJson(doc, json);
+// Fill one event from an event object
+static void store_event(calendar_event_t* e, JsonObject ev) {
+    const char* title = ev["title"] | "No Title";
+    strncpy(e->title, title, CALENDAR_TITLE_LEN - 1);
+    e->title[CALENDAR_TITLE_LEN - 1] = '\0';
+
+    const char* start_str = ev["start_str"] | "";
+    strncpy(e->start_str, start_str, CALENDAR_TIME_LEN - 1);
+    e->start_str[CALENDAR_TIME_LEN - 1] = '\0';
+
+    const char* start_time = ev["start_time"] | "";
+    strncpy(e->start_time, start_time, CALENDAR_TIME_LEN - 1);
+    e->start_time[CALENDAR_TIME_LEN - 1] = '\0';
+
+    const char* end_time = ev["end_time"] | "";
+    strncpy(e->end_time, end_time, CALENDAR_TIME_LEN - 1);
+    e->end_time[CALENDAR_TIME_LEN - 1] = '\0';
+
+    e->duration_min = ev["duration_min"] | 0;
+    e->is_all_day = ev["is_all_day"] | false;
+
+    const char* location = ev["location"] | "";
+    strncpy(e->location, location, CALENDAR_LOCATION_LEN - 1);
+    e->location[CALENDAR_LOCATION_LEN - 1] = '\0';
+
+    e->start_epoch = ev["start_epoch"] | 0u;
+    e->end_epoch = ev["end_epoch"] | 0u;
+}
+
+// Rebuild the start-time index over the timed events (insertion sort,
+// at most CALENDAR_MAX_EVENTS entries)
+static void build_order(calendar_state_t* cs) {
+    cs->order_count = 0;
+    for (uint8_t i = 0; i < cs->event_count; i++) {
+        const calendar_event_t* e = &cs->events[i];
+        if (e->is_all_day || !e->start_epoch || e->end_epoch < e->start_epoch) continue;
+
+        uint8_t pos = cs->order_count++;
+        while (pos > 0 && cs->events[cs->order[pos - 1]].start_epoch > e->start_epoch) {
+            cs->order[pos] = cs->order[pos - 1];
+            pos--;
+        }
+        cs->order[pos] = i;
+    }
+}
+
+bool calendar_data_set(const char* json) {
+    ArenaJsonDocument doc(4096);
+    DeserializationError err = usb_sync_parse_payload(doc, json);
 
     if (err) {
-        Serial.printf("CalendarData: JSON parse error: %s\n", err.c_str());
-        return;
+        LOGW("JSON parse error: %s", err.c_str());
+        return false;
     }
 
+    calendar_state_t* cs = (calendar_state_t*)snapshot_begin_write(&g_calendar_snap);
+
     // Parse events array
     JsonArray events = doc["events"];
-    g_calendar_state.event_count = 0;
+    cs->event_count = 0;
 
     if (!events.isNull()) {
         for (JsonObject ev : events) {
-            if (g_calendar_state.event_count >= CALENDAR_MAX_EVENTS) break;
+            if (cs->event_count >= CALENDAR_MAX_EVENTS) break;
 
-            calendar_event_t *e = &g_calendar_state.events[g_calendar_state.event_count];
+            store_event(&cs->events[cs->event_count], ev);
+            cs->event_count++;
+        }
+    }
 
-            const char* title = ev["title"] | "No Title";
-            strncpy(e->title, title, CALENDAR_TITLE_LEN - 1);
-            e->title[CALENDAR_TITLE_LEN - 1] = '\0';
+    // Next meeting minutes (pre-computed by Mac) - fallback without epochs
+    cs->next_meeting_min = doc["next_meeting_min"] | -2;
+    build_order(cs);
 
-            const char* start_str = ev["start_str"] | "";
-            strncpy(e->start_str, start_str, CALENDAR_TIME_LEN - 1);
-            e->start_str[CALENDAR_TIME_LEN - 1] = '\0';
+    cs->synced = true;
+    bool changed = snapshot_publish(&g_calendar_snap);
 
-            const char* start_time = ev["start_time"] | "";
-            strncpy(e->start_time, start_time, CALENDAR_TIME_LEN - 1);
-            e->start_time[CALENDAR_TIME_LEN - 1] = '\0';
+    LOGI("%d events, next in %d min", cs->event_count,
+         calendar_data_next_meeting(cs, (uint32_t)time(NULL), NULL));
+    return changed;
+}
 
-            const char* end_time = ev["end_time"] | "";
-            strncpy(e->end_time, end_time, CALENDAR_TIME_LEN - 1);
-            e->end_time[CALENDAR_TIME_LEN - 1] = '\0';
+void calendar_data_restore(const calendar_state_t* saved) {
+    calendar_state_t* cs = (calendar_state_t*)snapshot_begin_write(&g_calendar_snap);
+    memcpy(cs, saved, sizeof(*cs));
+    cs->next_meeting_min = -2;  // The Mac's countdown is out of date
+    build_order(cs);
+    if (snapshot_publish(&g_calendar_snap)) data_bus_publish(DATA_TOPIC_CALENDAR);
+}
 
-            e->duration_min = ev["duration_min"] | 0;
-            e->is_all_day = ev["is_all_day"] | false;
+void calendar_data_snapshot(calendar_state_t* out) {
+    snapshot_read(&g_calendar_snap, out);
+}
 
-            const char* location = ev["location"] | "";
-            strncpy(e->location, location, CALENDAR_LOCATION_LEN - 1);
-            e->location[CALENDAR_LOCATION_LEN - 1] = '\0';
+uint8_t calendar_data_get_count(void) {
+    return calendar_live()->event_count;
+}
 
-            g_calendar_state.event_count++;
-        }
+const calendar_event_t* calendar_data_get_event(uint8_t index) {
+    const calendar_state_t* cs = calendar_live();
+    if (index >= cs->event_count) return NULL;
+    return &cs->events[index];
+}
+
+int16_t calendar_data_next_meeting(const calendar_state_t* cs, uint32_t now,
+                                   const calendar_event_t** next) {
+    if (next) *next = NULL;
+
+    if (now < CALENDAR_CLOCK_VALID_EPOCH || cs->order_count == 0) {
+        if (next && cs->event_count > 0) *next = &cs->events[0];
+        return cs->next_meeting_min;
     }
 
-    // Next meeting minutes (pre-computed by Mac)
-    g_calendar_state.next_meeting_min = doc["next_meeting_min"] | -2;
+    // First event by start time that hasn't ended
+    for (uint8_t i = 0; i < cs->order_count; i++) {
+        const calendar_event_t* e = &cs->events[cs->order[i]];
+        if (e->end_epoch <= now) continue;
+        if (next) *next = e;
+        if (e->start_epoch <= now) return -1;
+        uint32_t mins = (e->start_epoch - now) / 60;
+        return mins > INT16_MAX ? INT16_MAX : (int16_t)mins;
+    }
+    return -2;
+}
 
-    g_calendar_state.synced = true;
+bool calendar_data_event_ended(const calendar_event_t* ev, uint32_t now) {
+    return ev->end_epoch && now >= CALENDAR_CLOCK_VALID_EPOCH && ev->end_epoch <= now;
+}
 
-    Serial.printf("CalendarData: %d events, next in %d min\n",
-                  g_calendar_state.event_count, g_calendar_state.next_meeting_min);
+int16_t calendar_data_get_next_meeting_min(void) {
+    return calendar_data_next_meeting(calendar_live(), (uint32_t)time(NULL), NULL);
 }
 
-uint8_t calendar_data_get_count(void) {
-    return g_calendar_state.event_count;
+bool calendar_data_is_synced(void) {
+    return calendar_live()->synced;
 }
 
-const calendar_event_t* calendar_data_get_event(uint8_t index) {
-    if (index >= g_calendar_state.event_count) return NULL;
-    return &g_calendar_state.events[index];
+// CALENDAR:<json> - calendar data from Mac
+static void handle_calendar_command(const char* payload) {
+    bool changed = calendar_data_set(payload);
+    usb_sync_printf("CALENDAR_OK\n");
+    warm_start_note_update(DATA_TOPIC_CALENDAR, changed);
+    if (changed) data_bus_publish(DATA_TOPIC_CALENDAR);
 }
 
-int16_t calendar_data_get_next_meeting_min(void) {
-    return g_calendar_state.next_meeting_min;
+// One event object from the stream - parsed on its own, written straight
+// into the back buffer. It is published when the stream ends.
+static void calendar_stream_record(const char* json, size_t len) {
+    if (g_stream_count >= CALENDAR_MAX_EVENTS) return;
+
+    ArenaJsonDocument doc(1024);
+    DeserializationError err = deserializeJson(doc, json, len);
+    if (err) {
+        LOGW("Stream record parse error: %s", err.c_str());
+        return;
+    }
+    store_event(&g_stream_state->events[g_stream_count++], doc.as<JsonObject>());
 }
 
-bool calendar_data_is_synced(void) {
-    return g_calendar_state.synced;
+static void calendar_stream_begin(void) {
+    g_stream_state = (calendar_state_t*)snapshot_begin_write(&g_calendar_snap);
+    g_stream_count = 0;
+    // Events sit at depth 2: {"events":[{...}],...}
+    json_stream_begin(&g_calendar_stream, 2, calendar_stream_record);
+}
+
+static void calendar_stream_feed(const char* data, size_t len) {
+    json_stream_feed(&g_calendar_stream, data, len);
+}
+
+static void calendar_stream_end(bool complete) {
+    calendar_state_t* cs = g_stream_state;
+    g_stream_state = NULL;
+    cs->event_count = g_stream_count;
+
+    // Fields outside the event list, e.g. {"events":[],"next_meeting_min":5}
+    StaticJsonDocument<256> doc;
+    const char* skeleton = json_stream_skeleton(&g_calendar_stream);
+    if (complete && skeleton && !deserializeJson(doc, skeleton)) {
+        cs->next_meeting_min = doc["next_meeting_min"] | -2;
+    }
+    build_order(cs);
+
+    if (!complete) {
+        LOGW("Calendar stream cut off after %d events", g_stream_count);
+        if (snapshot_publish(&g_calendar_snap)) data_bus_publish(DATA_TOPIC_CALENDAR);
+        return;
+    }
+
+    cs->synced = true;
+    bool changed = snapshot_publish(&g_calendar_snap);
+    LOGI("Streamed %d events, next in %d min", cs->event_count,
+         calendar_data_next_meeting(cs, (uint32_t)time(NULL), NULL));
+    usb_sync_printf("CALENDAR_OK\n");
+    warm_start_note_update(DATA_TOPIC_CALENDAR, changed);
+    if (changed) data_bus_publish(DATA_TOPIC_CALENDAR);
 }
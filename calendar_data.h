@@ -13,6 +13,8 @@ extern "C" {
 #define CALENDAR_TITLE_LEN 32
 #define CALENDAR_TIME_LEN 8
 #define CALENDAR_LOCATION_LEN 32
+// Wall clock below this is taken as "not set yet" (2023-11-14)
+#define CALENDAR_CLOCK_VALID_EPOCH 1700000000u
 
 // Single calendar event
 typedef struct {
@@ -23,26 +25,47 @@ typedef struct {
     uint16_t duration_min;                   // Duration in minutes
     bool is_all_day;                         // All-day event flag
     char location[CALENDAR_LOCATION_LEN];    // e.g. "Zoom", "Room A"
+    uint32_t start_epoch;                    // Unix time, 0 = not sent
+    uint32_t end_epoch;
 } calendar_event_t;
 
 // Full calendar state
 typedef struct {
     calendar_event_t events[CALENDAR_MAX_EVENTS];
     uint8_t event_count;
-    int16_t next_meeting_min;    // Minutes until next: -1 = in progress, -2 = none
+    // Timed events with epochs, by start time (indices into events)
+    uint8_t order[CALENDAR_MAX_EVENTS];
+    uint8_t order_count;
+    int16_t next_meeting_min;    // As sent by the Mac: -1 = in progress, -2 = none
     bool synced;                 // true if data received from Mac
 } calendar_state_t;
 
 // Initialize calendar data module
 void calendar_data_init(void);
 
-// Parse calendar JSON from Mac companion
-void calendar_data_set(const char* json);
+// Parse calendar JSON from Mac companion; true if the state changed
+bool calendar_data_set(const char* json);
 
-// Getters
+// Install a state saved by warm_start
+void calendar_data_restore(const calendar_state_t* saved);
+
+// Consistent copy of the whole state - use this from the UI
+void calendar_data_snapshot(calendar_state_t* out);
+
+// Next meeting at unix time now: minutes until it starts, -1 if one is in
+// progress, -2 if none is left; *next (if not NULL) gets the event or NULL.
+// Counts down from the event epochs on the device; falls back to the
+// Mac's next_meeting_min while the clock is unset or epochs are missing.
+int16_t calendar_data_next_meeting(const calendar_state_t* cs, uint32_t now,
+                                   const calendar_event_t** next);
+
+// True if the event has ended by unix time now (false without epochs)
+bool calendar_data_event_ended(const calendar_event_t* ev, uint32_t now);
+
+// Getters - point into the live buffer, valid until the next update
 uint8_t calendar_data_get_count(void);
 const calendar_event_t* calendar_data_get_event(uint8_t index);
-int16_t calendar_data_get_next_meeting_min(void);
+int16_t calendar_data_get_next_meeting_min(void);   // From the current clock
 bool calendar_data_is_synced(void);
 
 #ifdef __cplusplus
@@ -0,0 +1,188 @@
+/*
+ * Clock Sync Implementation
+ *
+ * NTP-style clock synchronization over USB:
+ *   host   -> TIMESYNC:<t1>                 host clock at send (us since epoch)
+ *   device -> TIMESYNC:<t1>:<t2>:<t3>       device clock at receive and reply
+ * The host takes t4 on receipt, repeats the exchange a few times and sends
+ * the offset from the sample with the shortest round trip:
+ *   host   -> TIMEADJ:<offset_us>:<delay_us>[:<POSIX TZ>]
+ *   device -> TIMEADJ_OK:<STEP|SLEW>:<drift_ppb>
+ * The clock runs on UTC; the host's time zone comes along so localtime()
+ * shows its wall time.
+ *
+ * Small offsets are slewed with adjtime() so session timestamps never jump.
+ * The residual offset seen at each sync feeds a drift model that is applied
+ * every CLOCK_SYNC_DRIFT_PERIOD_S between syncs.
+ */
+
+#define LOG_TAG "ClockSync"
+#include "clock_sync.h"
+#include "debug_log.h"
+#include "usb_sync.h"
+#include <Arduino.h>
+#include <esp_timer.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sys/time.h>
+
+static clock_sync_state_t g_clock;
+static SemaphoreHandle_t g_clock_mux = NULL;     // TIMEADJ (parser task) vs drift timer
+static int64_t g_last_adjust_mono_us = 0;        // esp_timer time of the last TIMEADJ
+static int64_t g_last_drift_mono_us = 0;         // esp_timer time of the last drift tick
+static int64_t g_drift_remainder = 0;            // Sub-microsecond carry, ppb * us
+static esp_timer_handle_t g_drift_timer = NULL;
+
+static void handle_timesync_command(const char* payload);
+static void handle_timeadj_command(const char* payload);
+static void drift_tick(void* arg);
+
+void clock_sync_init(void) {
+    memset(&g_clock, 0, sizeof(g_clock));
+    g_clock_mux = xSemaphoreCreateMutex();
+    g_last_drift_mono_us = esp_timer_get_time();
+
+    esp_timer_create_args_t args;
+    memset(&args, 0, sizeof(args));
+    args.callback = drift_tick;
+    args.name = "clock_drift";
+    if (esp_timer_create(&args, &g_drift_timer) == ESP_OK) {
+        esp_timer_start_periodic(g_drift_timer, CLOCK_SYNC_DRIFT_PERIOD_S * 1000000ULL);
+    } else {
+        LOGW("Drift timer unavailable");
+    }
+    LOGI("Initialized");
+
+    usb_sync_register_command("TIMESYNC", handle_timesync_command);
+    usb_sync_register_command("TIMEADJ", handle_timeadj_command);
+}
+
+const clock_sync_state_t* clock_sync_get_state(void) {
+    return &g_clock;
+}
+
+static int64_t wall_now_us(void) {
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return (int64_t)tv.tv_sec * 1000000 + tv.tv_usec;
+}
+
+static struct timeval us_to_timeval(int64_t us) {
+    struct timeval tv;
+    tv.tv_sec = us / 1000000;
+    tv.tv_usec = us % 1000000;
+    if (tv.tv_usec < 0) {
+        tv.tv_usec += 1000000;
+        tv.tv_sec--;
+    }
+    return tv;
+}
+
+// Add delta to whatever adjtime() slew is still outstanding
+static void slew_add(int64_t delta_us) {
+    struct timeval old;
+    int64_t pending = 0;
+    if (adjtime(NULL, &old) == 0) {
+        pending = (int64_t)old.tv_sec * 1000000 + old.tv_usec;
+    }
+    struct timeval tv = us_to_timeval(pending + delta_us);
+    adjtime(&tv, NULL);
+}
+
+// Apply the drift model for the time since the last tick
+static void drift_tick(void* arg) {
+    xSemaphoreTake(g_clock_mux, portMAX_DELAY);
+    int64_t now = esp_timer_get_time();
+    int64_t elapsed = now - g_last_drift_mono_us;
+    g_last_drift_mono_us = now;
+
+    if (g_clock.synced && g_clock.drift_ppb != 0) {
+        g_drift_remainder += (int64_t)g_clock.drift_ppb * elapsed;
+        int64_t correction = g_drift_remainder / 1000000000LL;
+        if (correction != 0) {
+            g_drift_remainder -= correction * 1000000000LL;
+            slew_add(correction);
+        }
+    }
+    xSemaphoreGive(g_clock_mux);
+}
+
+// Handle TIMESYNC:<t1> - echo t1 with device receive/transmit times
+static void handle_timesync_command(const char* payload) {
+    // Receive time, backdated by how long the command waited in the parser
+    uint32_t queued_us = micros() - usb_sync_command_rx_us();
+    int64_t t2 = wall_now_us() - queued_us;
+
+    char* end;
+    long long t1 = strtoll(payload, &end, 10);
+    if (end == payload) {
+        usb_sync_printf("ERROR:Invalid TIMESYNC\n");
+        return;
+    }
+
+    int64_t t3 = wall_now_us();
+    usb_sync_printf("TIMESYNC:%lld:%lld:%lld\n", t1, (long long)t2, (long long)t3);
+}
+
+// Handle TIMEADJ:<offset_us>:<delay_us>[:<tz>] - correct the clock by
+// offset_us and take the host's time zone (POSIX TZ, e.g. "LOC-2:00")
+static void handle_timeadj_command(const char* payload) {
+    char* end;
+    long long offset = strtoll(payload, &end, 10);
+    if (end == payload) {
+        usb_sync_printf("ERROR:Invalid TIMEADJ\n");
+        return;
+    }
+    unsigned long delay_us = 0;
+    const char* tz = NULL;
+    if (*end == ':') {
+        delay_us = strtoul(end + 1, &end, 10);
+        if (*end == ':' && end[1]) tz = end + 1;
+    }
+    if (tz) {
+        setenv("TZ", tz, 1);
+        tzset();
+    }
+
+    xSemaphoreTake(g_clock_mux, portMAX_DELAY);
+    int64_t now = esp_timer_get_time();
+    bool step = !g_clock.synced || llabs(offset) > CLOCK_SYNC_STEP_US;
+
+    if (step) {
+        // Drop any slew in progress, then jump
+        struct timeval zero = { .tv_sec = 0, .tv_usec = 0 };
+        adjtime(&zero, NULL);
+        struct timeval tv = us_to_timeval(wall_now_us() + offset);
+        settimeofday(&tv, NULL);
+    } else {
+        // The measured offset already covers the unapplied part of the
+        // running slew, so it replaces it rather than adding to it
+        struct timeval tv = us_to_timeval(offset);
+        adjtime(&tv, NULL);
+
+        // What remains after the model ran is drift it did not predict;
+        // fold half of it in to damp measurement noise
+        int64_t span = now - g_last_adjust_mono_us;
+        if (g_clock.synced && span >= CLOCK_SYNC_MIN_DRIFT_SPAN_S * 1000000LL) {
+            int64_t drift = g_clock.drift_ppb + (offset * 1000000000LL / span) / 2;
+            if (drift > CLOCK_SYNC_MAX_DRIFT_PPB) drift = CLOCK_SYNC_MAX_DRIFT_PPB;
+            if (drift < -CLOCK_SYNC_MAX_DRIFT_PPB) drift = -CLOCK_SYNC_MAX_DRIFT_PPB;
+            g_clock.drift_ppb = (int32_t)drift;
+        }
+    }
+
+    g_last_adjust_mono_us = now;
+    g_clock.last_offset_us = offset;
+    g_clock.last_delay_us = delay_us;
+    g_clock.sync_count++;
+    g_clock.synced = true;
+    int32_t drift_ppb = g_clock.drift_ppb;
+    xSemaphoreGive(g_clock_mux);
+
+    usb_sync_printf("TIMEADJ_OK:%s:%ld\n", step ? "STEP" : "SLEW", (long)drift_ppb);
+    LOGI("%s %lld us (rtt %lu us), drift %ld ppb, TZ %s",
+         step ? "Stepped" : "Slewing", offset, delay_us, (long)drift_ppb, tz ? tz : "unchanged");
+}
@@ -0,0 +1,39 @@
+#ifndef CLOCK_SYNC_H
+#define CLOCK_SYNC_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Offsets larger than this step the clock; smaller ones are slewed
+#define CLOCK_SYNC_STEP_US 500000
+// Interval between drift corrections applied from the model
+#define CLOCK_SYNC_DRIFT_PERIOD_S 60
+// Minimum time between syncs for a drift estimate
+#define CLOCK_SYNC_MIN_DRIFT_SPAN_S 600
+// Drift model clamp (parts per billion)
+#define CLOCK_SYNC_MAX_DRIFT_PPB 500000
+
+// Clock sync state
+typedef struct {
+    int64_t last_offset_us;  // Correction applied at the last sync
+    uint32_t last_delay_us;  // Round trip of the sample it was taken from
+    int32_t drift_ppb;       // Model: + = device clock runs slow
+    uint32_t sync_count;
+    bool synced;             // Clock set by TIMESYNC since boot
+} clock_sync_state_t;
+
+// Initialize clock sync - registers TIMESYNC/TIMEADJ, call before usb_sync_init
+void clock_sync_init(void);
+
+// Get current clock sync state
+const clock_sync_state_t* clock_sync_get_state(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CLOCK_SYNC_H
@@ -134,9 +134,12 @@ class CalendarClient:
         Returns dict ready to serialize and send to device:
         {
             "events": [{title, start_str, start_time, end_time,
-                        duration_min, is_all_day, location}, ...],
+                        duration_min, is_all_day, location,
+                        start_epoch, end_epoch}, ...],
             "next_meeting_min": 15  (-1 = in progress, -2 = none)
         }
+        The device counts down from start_epoch/end_epoch itself;
+        next_meeting_min is only used until its clock is set.
         Returns None on failure.
         """
         try:
@@ -241,6 +244,9 @@ class CalendarClient:
                     "duration_min": duration_min,
                     "is_all_day": is_all_day,
                     "location": location,
+                    # Local wall time, same assumption as "now" above
+                    "start_epoch": int(start_parsed.timestamp()),
+                    "end_epoch": int(end_parsed.timestamp()),
                 })
 
             logger.info(f"Fetched {len(events)} calendar events, next in {next_meeting_min} min")
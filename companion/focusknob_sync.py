@@ -21,6 +21,9 @@ import json
 import signal
 import time
 import uuid
+import base64
+import binascii
+import struct
 import logging
 import datetime
 import subprocess
@@ -43,6 +46,16 @@ DEVICE_NAME = "FocusKnob"
 POLL_INTERVAL = 2.0  # seconds between checking for device
 PING_INTERVAL = 5.0  # seconds between pings when connected
 COMMAND_TIMEOUT = 3.0  # seconds to wait for response
+FRAME_ACK_TIMEOUT = 0.25  # seconds to wait for ACK/NAK of a framed message
+FRAME_MAX_RETRIES = 5
+Z_WINDOW = 4096  # max match distance the device decoder accepts
+Z_MIN_SIZE = 256  # don't bother compressing shorter commands
+BATCH_SEP = "\x1e"  # between commands in BATCH:<cmd><sep><cmd>...
+BATCH_MAX_SIZE = 8000  # device command buffer is 8192 bytes (HELLO reports it)
+JIRA_DOC_SIZE = 8192  # device Jira parse document when HELLO does not report one
+PROTOCOL_VERSION = 2  # sync protocol spoken by this companion (HELLO)
+TIMESYNC_SAMPLES = 5  # exchanges per clock sync; the fastest round trip wins
+TIME_RESYNC_INTERVAL = 1800  # seconds between clock syncs (device models drift)
 
 # Logging setup
 LOG_DIR = Path.home() / "Library" / "Logs" / "FocusKnob"
@@ -169,6 +182,201 @@ class NotionClient:
             return False
 
 
+def cobs_encode(data: bytes) -> bytes:
+    """COBS-encode a block (no delimiters)."""
+    out = bytearray()
+    block = bytearray()
+    for b in data:
+        if b == 0:
+            out.append(len(block) + 1)
+            out += block
+            block.clear()
+        else:
+            block.append(b)
+            if len(block) == 254:
+                out.append(255)
+                out += block
+                block.clear()
+    out.append(len(block) + 1)
+    out += block
+    return bytes(out)
+
+
+def build_frame(frame_type: bytes, seq: int, frag: int, data: bytes) -> bytes:
+    """Build one wire frame: 0x00 COBS([type][seq][frag][data][crc16]) 0x00."""
+    body = frame_type + bytes([seq & 0xFF, frag]) + data
+    crc = binascii.crc_hqx(body, 0xFFFF)
+    return b"\x00" + cobs_encode(body + crc.to_bytes(2, "big")) + b"\x00"
+
+
+def _lz4_len(out: bytearray, n: int):
+    while n >= 255:
+        out.append(255)
+        n -= 255
+    out.append(n)
+
+
+def lz4_compress(data: bytes, window: int = Z_WINDOW) -> bytes:
+    """Greedy LZ4-block compressor with matches limited to window."""
+    out = bytearray()
+    n = len(data)
+    table = {}
+    anchor = 0
+    i = 0
+    limit = n - 12  # last match must start at least 12 bytes before the end
+    while i < limit:
+        key = data[i:i + 4]
+        cand = table.get(key)
+        table[key] = i
+        if cand is None or i - cand > window:
+            i += 1
+            continue
+
+        m = 4
+        while i + m < n - 5 and data[cand + m] == data[i + m]:
+            m += 1
+
+        lit = i - anchor
+        ml = m - 4
+        out.append((min(lit, 15) << 4) | min(ml, 15))
+        if lit >= 15:
+            _lz4_len(out, lit - 15)
+        out += data[anchor:i]
+        out += (i - cand).to_bytes(2, "little")
+        if ml >= 15:
+            _lz4_len(out, ml - 15)
+
+        i += m
+        anchor = i
+
+    lit = n - anchor
+    out.append(min(lit, 15) << 4)
+    if lit >= 15:
+        _lz4_len(out, lit - 15)
+    out += data[anchor:]
+    return bytes(out)
+
+
+def wire_bytes(command: str) -> bytes:
+    """Command text as sent; binary payloads ride in surrogate escapes."""
+    return command.encode("utf-8", "surrogateescape")
+
+
+def json_doc_cost(value) -> int:
+    """Bytes an ArduinoJson 6 document on the device needs for value.
+
+    One 16-byte slot per object member or array element, plus a copy of
+    every key and string (keys counted each time - an upper bound).
+    """
+    if isinstance(value, dict):
+        return sum(16 + len(k.encode()) + 1 + json_doc_cost(v) for k, v in value.items())
+    if isinstance(value, list):
+        return sum(16 + json_doc_cost(v) for v in value)
+    if isinstance(value, str):
+        return len(value.encode()) + 1
+    return 0
+
+
+def msgpack_encode(obj) -> bytes:
+    """Minimal MessagePack encoder for JSON-shaped data."""
+    out = bytearray()
+    _msgpack_pack(obj, out)
+    return bytes(out)
+
+
+def _msgpack_pack(obj, out: bytearray):
+    if obj is None:
+        out.append(0xC0)
+    elif obj is True:
+        out.append(0xC3)
+    elif obj is False:
+        out.append(0xC2)
+    elif isinstance(obj, int):
+        if 0 <= obj < 0x80:
+            out.append(obj)
+        elif -32 <= obj < 0:
+            out.append(obj & 0xFF)
+        elif 0 <= obj <= 0xFF:
+            out += b"\xcc" + struct.pack(">B", obj)
+        elif 0 <= obj <= 0xFFFF:
+            out += b"\xcd" + struct.pack(">H", obj)
+        elif 0 <= obj <= 0xFFFFFFFF:
+            out += b"\xce" + struct.pack(">I", obj)
+        elif obj >= 0:
+            out += b"\xcf" + struct.pack(">Q", obj)
+        elif obj >= -0x80:
+            out += b"\xd0" + struct.pack(">b", obj)
+        elif obj >= -0x8000:
+            out += b"\xd1" + struct.pack(">h", obj)
+        elif obj >= -0x80000000:
+            out += b"\xd2" + struct.pack(">i", obj)
+        else:
+            out += b"\xd3" + struct.pack(">q", obj)
+    elif isinstance(obj, float):
+        try:
+            f32 = struct.pack(">f", obj)
+        except OverflowError:
+            f32 = None
+        if f32 is not None and struct.unpack(">f", f32)[0] == obj:
+            out += b"\xca" + f32
+        else:
+            out += b"\xcb" + struct.pack(">d", obj)
+    elif isinstance(obj, str):
+        raw = obj.encode()
+        n = len(raw)
+        if n < 32:
+            out.append(0xA0 | n)
+        elif n <= 0xFF:
+            out += b"\xd9" + struct.pack(">B", n)
+        elif n <= 0xFFFF:
+            out += b"\xda" + struct.pack(">H", n)
+        else:
+            out += b"\xdb" + struct.pack(">I", n)
+        out += raw
+    elif isinstance(obj, (list, tuple)):
+        n = len(obj)
+        if n < 16:
+            out.append(0x90 | n)
+        elif n <= 0xFFFF:
+            out += b"\xdc" + struct.pack(">H", n)
+        else:
+            out += b"\xdd" + struct.pack(">I", n)
+        for item in obj:
+            _msgpack_pack(item, out)
+    elif isinstance(obj, dict):
+        n = len(obj)
+        if n < 16:
+            out.append(0x80 | n)
+        elif n <= 0xFFFF:
+            out += b"\xde" + struct.pack(">H", n)
+        else:
+            out += b"\xdf" + struct.pack(">I", n)
+        for key, value in obj.items():
+            _msgpack_pack(str(key), out)
+            _msgpack_pack(value, out)
+    else:
+        raise TypeError(f"Cannot MessagePack-encode {type(obj).__name__}")
+
+
+def z_envelope(command: str, window: int = Z_WINDOW) -> str:
+    """Wrap a command as Z:<len>:<base64 LZ4 block>."""
+    raw = wire_bytes(command)
+    packed = base64.b64encode(lz4_compress(raw, window)).decode()
+    return f"Z:{len(raw)}:{packed}"
+
+
+def is_device_log(line: str) -> bool:
+    """Route device debug lines ('#<level> <tag>: ...') to the local log.
+
+    Returns True when the line was a debug line and must not be treated as a
+    protocol response.
+    """
+    if not line.startswith("#"):
+        return False
+    logger.debug(f"Device: {line[1:]}")
+    return True
+
+
 class SerialMonitor:
     """Monitors USB serial ports for FocusKnob device."""
 
@@ -176,6 +384,20 @@ class SerialMonitor:
         self.serial_port = None
         self.connected = False
         self.port_name = None
+        self.framed = False     # COBS/CRC frame transport negotiated
+        self.frame_data = 0     # payload bytes per fragment
+        self._frame_seq = 0
+        self.compress = False   # device accepts Z: envelopes
+        self.request_ids = False  # device closes "@<id> ..." requests with END:<id>
+        self.batch = False      # device runs BATCH: messages
+        self.msgpack = False    # data payloads go as MessagePack (framed only)
+        self.stream = False     # device takes *_STREAM text lines of any length
+        self.jira_paging = False  # device loads Jira issues page by page
+        self.z_window = Z_WINDOW
+        self.batch_max = BATCH_MAX_SIZE
+        self.device_info = {}   # HELLO reply, empty for firmware without HELLO
+        self._request_id = 0
+        self.last_complete = False  # last send_command() saw its END marker
 
     def find_device(self) -> Optional[str]:
         """Find FocusKnob device port."""
@@ -240,37 +462,351 @@ class SerialMonitor:
         self.serial_port = None
         self.connected = False
         self.port_name = None
+        self.framed = False
+        self.compress = False
+        self.request_ids = False
+        self.batch = False
+        self.msgpack = False
+        self.stream = False
+        self.jira_paging = False
+        self.z_window = Z_WINDOW
+        self.batch_max = BATCH_MAX_SIZE
+        self.device_info = {}
         logger.info("Disconnected from FocusKnob")
 
+    def negotiate(self):
+        """Pick the fastest transport features the device supports.
+
+        HELLO reports capabilities and compiled-in sizes in one round trip;
+        firmware without it is probed feature by feature.
+        """
+        hello = self._hello()
+        if hello is None:
+            # Tagged requests first - later probes then end at END:<id>
+            # instead of waiting out a timeout
+            self.negotiate_request_ids()
+            self.negotiate_framing()
+            self.negotiate_compression()
+            self.negotiate_batch()
+            self.negotiate_encoding()
+            return
+
+        self.device_info = hello
+        caps = set(hello.get("caps", []))
+        self.request_ids = "REQID" in caps
+        if "FRAMED" in caps:
+            self.negotiate_framing()
+        self.compress = "Z" in caps
+        self.z_window = min(Z_WINDOW, hello.get("z_window", Z_WINDOW))
+        self.batch = "BATCH" in caps and self.request_ids
+        self.batch_max = hello.get("buffer", BATCH_MAX_SIZE + 192) - 192
+        self.msgpack = "MSGPACK" in caps and self.framed
+        self.stream = "STREAM" in caps
+        self.jira_paging = "JIRA_PAGE" in caps
+        logger.info(f"Device protocol v{hello.get('proto')}: "
+                    f"{'framed' if self.framed else 'text'}"
+                    f"{', Z' if self.compress else ''}{', batch' if self.batch else ''}"
+                    f"{', msgpack' if self.msgpack else ''}, {hello.get('buffer')} B buffer")
+
+    def _hello(self) -> Optional[dict]:
+        """Send HELLO and return the device's capability dict, or None."""
+        if not self.connected or not self.serial_port:
+            return None
+
+        try:
+            self.serial_port.write(f"HELLO:{PROTOCOL_VERSION}\n".encode())
+            self.serial_port.flush()
+            start = time.time()
+            while time.time() - start < 1.0:
+                if self.serial_port.in_waiting:
+                    line = self.serial_port.readline().decode('utf-8', errors='ignore').strip()
+                    if line.startswith("HELLO:"):
+                        return json.loads(line[6:])
+                    if line.startswith("ERROR:"):
+                        break
+                else:
+                    time.sleep(0.01)
+        except Exception as e:
+            logger.debug(f"HELLO failed: {e}")
+        return None
+
+    def negotiate_framing(self) -> bool:
+        """Switch to the framed transport if the firmware supports it.
+
+        Older firmware answers ERROR:Unknown command and we stay on the
+        chunked text protocol.
+        """
+        if not self.connected or not self.serial_port:
+            return False
+
+        try:
+            self.serial_port.write(b"FRAMED\n")
+            self.serial_port.flush()
+            start = time.time()
+            while time.time() - start < 1.0:
+                if self.serial_port.in_waiting:
+                    line = self.serial_port.readline().decode('utf-8', errors='ignore').strip()
+                    if line.startswith("FRAMED_OK:"):
+                        self.frame_data = int(line[10:])
+                        self.framed = True
+                        logger.info(f"Framed transport enabled ({self.frame_data} B fragments)")
+                        return True
+                    if line.startswith("ERROR:"):
+                        break
+                else:
+                    time.sleep(0.01)
+        except Exception as e:
+            logger.debug(f"Framing negotiation failed: {e}")
+
+        logger.info("Framed transport not supported - using text protocol")
+        return False
+
+    def negotiate_compression(self) -> bool:
+        """Probe for Z: envelope support by sending a compressed PING."""
+        if not self.connected:
+            return False
+        self.compress = "PONG" in self.send_command(z_envelope("PING"))
+        logger.info(f"Compressed payloads {'enabled' if self.compress else 'not supported'}")
+        return self.compress
+
+    def negotiate_request_ids(self) -> bool:
+        """Probe for tagged requests; replies then end at END:<id> instead
+        of a COMMAND_TIMEOUT quiet period."""
+        if not self.connected:
+            return False
+        self.request_ids = True
+        self.send_command("PING")
+        self.request_ids = self.last_complete
+        logger.info(f"Request ids {'enabled' if self.request_ids else 'not supported'}")
+        return self.request_ids
+
+    def negotiate_batch(self) -> bool:
+        """Probe for BATCH support (needs request ids to split replies)."""
+        if not self.connected or not self.request_ids:
+            self.batch = False
+            return False
+        self.batch = "PONG" in self.send_command(f"BATCH:PING{BATCH_SEP}PING")
+        logger.info(f"Batched commands {'enabled' if self.batch else 'not supported'}")
+        return self.batch
+
+    def negotiate_encoding(self) -> bool:
+        """Use MessagePack data payloads when the device parses them.
+
+        Binary payloads can't travel in text lines, so this needs frames.
+        """
+        self.msgpack = False
+        if not self.connected or not self.framed:
+            return False
+        for response in self.send_command("ENCODINGS"):
+            if response.startswith("ENCODINGS:"):
+                self.msgpack = "MSGPACK" in response[10:].split(",")
+        logger.info(f"MessagePack payloads {'enabled' if self.msgpack else 'not supported'}")
+        return self.msgpack
+
+    def data_command(self, verb: str, data, streamable: bool = False) -> str:
+        """Build VERB:<payload> in the negotiated data encoding.
+
+        A streamable payload too large for the device's command buffer
+        becomes a VERB_STREAM:<json> text line, which the device parses
+        record by record as it arrives.
+        """
+        if streamable and self.stream:
+            text = json.dumps(data, separators=(',', ':'))
+            if len(wire_bytes(text)) + len(verb) + 16 > self.batch_max:
+                return f"{verb}_STREAM:{text}"
+        if self.msgpack:
+            body = msgpack_encode(data)
+            return f"{verb}:M{len(body)}:" + body.decode("utf-8", "surrogateescape")
+        return f"{verb}:{json.dumps(data, separators=(',', ':'))}"
+
+    def send_batch(self, commands: List[str]) -> List[List[str]]:
+        """Send commands back-to-back and return the replies of each.
+
+        Commands are packed into BATCH messages of up to batch_max bytes,
+        each sent (framed/compressed) as one transfer; the device runs them
+        in order and ends each reply with END:<id>. Without BATCH support
+        every command is a separate round trip.
+        """
+        if not self.batch:
+            return [self.send_command(c) for c in commands]
+
+        results = []
+        group = []
+        size = 0
+        for command in commands:
+            cost = len(wire_bytes(command)) + 8  # "@<id> " and separator
+            if group and size + cost > self.batch_max:
+                results += self._send_batch_group(group)
+                group, size = [], 0
+            group.append(command)
+            size += cost
+        if group:
+            results += self._send_batch_group(group)
+        return results
+
+    def _send_batch_group(self, commands: List[str]) -> List[List[str]]:
+        """Send one BATCH message and split its reply lines at END:<id>."""
+        if len(commands) == 1:
+            return [self.send_command(commands[0])]
+
+        ids = []
+        tagged = []
+        for command in commands:
+            self._request_id = self._request_id % 999999 + 1
+            ids.append(self._request_id)
+            tagged.append(f"@{self._request_id} {command}")
+
+        results = [[] for _ in commands]
+        k = 0
+        for line in self.send_command("BATCH:" + BATCH_SEP.join(tagged)):
+            if k < len(ids) and line == f"END:{ids[k]}":
+                k += 1
+            else:
+                results[min(k, len(ids) - 1)].append(line)
+        return results
+
+    def _write_chunked(self, data: bytes):
+        """Write in small chunks (48 bytes) with short delays to avoid
+        ESP32-S3 USB CDC byte drops on large payloads."""
+        CHUNK_SIZE = 48
+        for i in range(0, len(data), CHUNK_SIZE):
+            self.serial_port.write(data[i:i + CHUNK_SIZE])
+            self.serial_port.flush()
+            if i + CHUNK_SIZE < len(data):
+                time.sleep(0.005)  # 5ms between chunks
+
+    def _send_framed(self, payload: bytes, responses: List[str]) -> bool:
+        """Send one message as CRC-checked fragments at full speed.
+
+        Lost or corrupted fragments are reported by the device in a
+        NAK:<seq>:<i>,<j> line and only those are resent. Lines that are
+        not ACK/NAK are appended to responses.
+        """
+        seq = self._frame_seq
+        self._frame_seq = (self._frame_seq + 1) & 0xFF
+
+        size = self.frame_data
+        chunks = [payload[i:i + size] for i in range(0, len(payload), size)] or [b""]
+        frames = [build_frame(b"E" if i == len(chunks) - 1 else b"D", seq, i, c)
+                  for i, c in enumerate(chunks)]
+
+        self.serial_port.write(b"".join(frames))
+        self.serial_port.flush()
+
+        for _ in range(FRAME_MAX_RETRIES):
+            start = time.time()
+            while time.time() - start < FRAME_ACK_TIMEOUT:
+                if not self.serial_port.in_waiting:
+                    time.sleep(0.002)
+                    continue
+                line = self.serial_port.readline().decode('utf-8', errors='ignore').strip()
+                if line == f"ACK:{seq}":
+                    return True
+                if line.startswith(f"NAK:{seq}:"):
+                    missing = [int(i) for i in line.split(":", 2)[2].split(",") if i]
+                    logger.debug(f"Resending fragments {missing} of message {seq}")
+                    self.serial_port.write(b"".join(frames[i] for i in missing if i < len(frames)))
+                    self.serial_port.flush()
+                    start = time.time()
+                elif line and not is_device_log(line):
+                    responses.append(line)
+
+            # No verdict - resend the final fragment to provoke ACK or NAK
+            self.serial_port.write(frames[-1])
+            self.serial_port.flush()
+
+        logger.warning(f"Framed message {seq} not acknowledged")
+        return False
+
+    def timesync_sample(self, responses: List[str]) -> Optional[tuple]:
+        """One TIMESYNC exchange, returns (t1, t2, t3, t4) in microseconds.
+
+        Sent as a plain text line and read with a blocking readline so t4
+        is taken as soon as the reply arrives. Unrelated lines read on the
+        way are appended to responses. Returns "unsupported" when the
+        firmware does not know TIMESYNC.
+        """
+        if not self.connected or not self.serial_port:
+            return None
+
+        saved_timeout = self.serial_port.timeout
+        try:
+            t1 = time.time_ns() // 1000
+            self.serial_port.write(f"TIMESYNC:{t1}\n".encode())
+            self.serial_port.flush()
+            self.serial_port.timeout = 0.5
+            deadline = time.time() + 1.0
+            while time.time() < deadline:
+                raw = self.serial_port.readline()
+                t4 = time.time_ns() // 1000
+                line = raw.decode('utf-8', errors='ignore').strip()
+                if not line or is_device_log(line):
+                    continue
+                if line.startswith(f"TIMESYNC:{t1}:"):
+                    _, _, t2, t3 = line.split(":")
+                    return (t1, int(t2), int(t3), t4)
+                if line.startswith("ERROR:Unknown command"):
+                    return "unsupported"
+                responses.append(line)
+        except Exception as e:
+            logger.debug(f"TIMESYNC failed: {e}")
+        finally:
+            # Later commands expect their usual read timeout
+            if self.serial_port:
+                self.serial_port.timeout = saved_timeout
+        return None
+
     def send_command(self, command: str) -> List[str]:
         """Send command and return response lines.
 
-        Writes in small chunks (48 bytes) with short delays to avoid
-        ESP32-S3 USB CDC byte drops on large payloads.
+        Uses the framed transport when negotiated, otherwise the chunked
+        text protocol. *_STREAM commands always go as one text line - the
+        device consumes them as they arrive, so they may exceed its buffer.
+        With request ids the call returns as soon as the END:<id> marker
+        arrives.
         """
+        self.last_complete = False
         if not self.connected or not self.serial_port:
             return []
 
         try:
-            data = f"{command}\n".encode()
-            CHUNK_SIZE = 48
-            for i in range(0, len(data), CHUNK_SIZE):
-                self.serial_port.write(data[i:i + CHUNK_SIZE])
-                self.serial_port.flush()
-                if i + CHUNK_SIZE < len(data):
-                    time.sleep(0.005)  # 5ms between chunks
+            streaming = command.split(":", 1)[0].endswith("_STREAM")
+            end_marker = None
+            if self.request_ids:
+                self._request_id = self._request_id % 999999 + 1
+                end_marker = f"END:{self._request_id}"
+                command = f"@{self._request_id} {command}"
+
+            if self.compress and not streaming and len(command) >= Z_MIN_SIZE:
+                packed = z_envelope(command, self.z_window)
+                if len(packed) < len(command):
+                    logger.debug(f"Compressed {len(command)} -> {len(packed)} bytes")
+                    command = packed
 
             responses = []
+            if self.framed and not streaming:
+                self._send_framed(wire_bytes(command), responses)
+            else:
+                self._write_chunked(wire_bytes(f"{command}\n"))
+
+            if end_marker in responses:
+                responses.remove(end_marker)
+                self.last_complete = True
+                return responses
+
             start = time.time()
             while time.time() - start < COMMAND_TIMEOUT:
                 if self.serial_port.in_waiting:
                     line = self.serial_port.readline().decode('utf-8', errors='ignore').strip()
-                    if line:
+                    if line == end_marker:
+                        self.last_complete = True
+                        break
+                    if line and not is_device_log(line):
                         responses.append(line)
                         # Reset timeout on each response
                         start = time.time()
                 else:
-                    time.sleep(0.01)
+                    time.sleep(0.002 if end_marker else 0.01)
 
             return responses
 
@@ -287,16 +823,22 @@ class SerialMonitor:
         try:
             self.serial_port.timeout = timeout
             line = self.serial_port.readline().decode('utf-8', errors='ignore').strip()
-            return line if line else None
+            if not line or is_device_log(line):
+                return None
+            return line
         except Exception as e:
             logger.debug(f"Read error: {e}")
             return None
 
     def send_ok(self):
         """Send OK acknowledgment."""
+        self.send_line("OK")
+
+    def send_line(self, line: str):
+        """Send a short line without waiting for responses."""
         if self.connected and self.serial_port:
             try:
-                self.serial_port.write(b"OK\n")
+                self.serial_port.write(f"{line}\n".encode())
                 self.serial_port.flush()
             except:
                 pass
@@ -305,14 +847,72 @@ class SerialMonitor:
 class TimeSync:
     """Handles time synchronization."""
 
+    @staticmethod
+    def posix_tz() -> str:
+        """The host's current UTC offset as a POSIX TZ string, e.g. "LOC-2:00".
+
+        Only the offset in effect now - the periodic resync carries DST
+        changes over.
+        """
+        offset = datetime.datetime.now().astimezone().utcoffset()
+        minutes = int(offset.total_seconds()) // 60
+        hours, mins = divmod(abs(minutes), 60)
+        # POSIX counts west of UTC as positive
+        return f"LOC{'-' if minutes >= 0 else '+'}{hours}:{mins:02d}"
+
     @staticmethod
     def get_current_time_iso() -> str:
         """Get current time in ISO8601 format."""
         return datetime.datetime.now().strftime("%Y-%m-%dT%H:%M:%S")
 
     @staticmethod
-    def sync_time(monitor: SerialMonitor) -> bool:
-        """Sync time to device."""
+    def sync_time(monitor: SerialMonitor, responses: Optional[List[str]] = None) -> bool:
+        """Sync device clock with an NTP-style TIMESYNC exchange.
+
+        Falls back to whole-second TIME on firmware without TIMESYNC.
+        Unrelated device lines read during the exchange go to responses.
+        """
+        if responses is None:
+            responses = []
+
+        best = None
+        for _ in range(TIMESYNC_SAMPLES):
+            sample = monitor.timesync_sample(responses)
+            if sample == "unsupported":
+                return TimeSync.sync_time_legacy(monitor)
+            if sample is None:
+                continue
+            t1, t2, t3, t4 = sample
+            delay = (t4 - t1) - (t3 - t2)
+            offset = ((t2 - t1) + (t3 - t4)) // 2  # device minus host
+            if best is None or delay < best[0]:
+                best = (delay, offset)
+
+        if best is None:
+            logger.warning("Time sync: no TIMESYNC reply")
+            return False
+
+        delay, offset = best
+        # The device clock is UTC; the time zone makes its local time ours
+        tz = TimeSync.posix_tz()
+        for response in monitor.send_command(f"TIMEADJ:{-offset}:{max(delay, 0)}:{tz}"):
+            if response.startswith("TIMEADJ_OK:"):
+                _, mode, drift = response.split(":")
+                logger.info(f"Time synced: {mode.lower()} {-offset} us "
+                            f"(rtt {delay} us, drift {drift} ppb, TZ {tz})")
+                return True
+            elif response.startswith("ERROR:"):
+                logger.error(f"Time sync failed: {response}")
+                return False
+            else:
+                responses.append(response)
+
+        logger.warning("Time sync: no response")
+        return False
+
+    @staticmethod
+    def sync_time_legacy(monitor: SerialMonitor) -> bool:
+        """Sync time to device with whole-second TIME."""
         time_str = TimeSync.get_current_time_iso()
         responses = monitor.send_command(f"TIME:{time_str}")
 
@@ -383,9 +983,29 @@ class FocusKnobSync:
         # Jira hours sync tracking
         self._last_jira_hours_sync = 0
 
+        # Clock sync tracking
+        self._last_time_sync = 0
+
+        # Jira issue sync tracking
+        self._last_jira_sync = 0
+
+        # Last Jira issue list acknowledged by the device (for JIRA_PATCH deltas).
+        # With paging the device holds only a prefix of _jira_issues, which
+        # serves its JIRA_PAGE requests.
+        self._jira_acked = {}
+        self._jira_acked_ver = None
+        self._jira_issues = []
+
+        # Note ids already added to Notion this connection (device resends
+        # notes whose NOTE_ACK was lost)
+        self._notes_synced = set()
+
         # Meeting end tracking
         self._prompted_meetings = set()  # (date_str, meeting_hash)
         self._last_calendar_events = []  # cached from last sync
+        self._calendar_sent_key = None    # events the device acknowledged
+        # Device warm-start snapshot holding the data last synced to it
+        self._device_snapshot = None
         self._today_str = ""  # for daily reset
 
         # Start IPC server for menu bar app communication
@@ -470,55 +1090,81 @@ class FocusKnobSync:
                 logger.warning(f"Failed to load calendar config: {e}")
         return None, None
 
+    def _send_request(self, request):
+        """Send one (command, on_reply) request built by a *_request() method."""
+        if request:
+            command, on_reply = request
+            on_reply(self.monitor.send_command(command))
+
     def sync_calendar(self):
         """Fetch calendar events and send to device."""
+        self._send_request(self._calendar_request())
+
+    def _calendar_request(self):
+        """Fetch calendar events; returns (command, on_reply) or None."""
         if not self.calendar:
-            return
+            return None
 
         data = self.calendar.get_upcoming_events()
         if data is None:
             logger.warning("Failed to fetch calendar data")
-            return
+            return None
 
         # Cache events for meeting-end tracking
         self._last_calendar_events = data.get("events", [])
 
-        cal_json = json.dumps(data, separators=(",", ":"))
-        command = f"CALENDAR:{cal_json}"
-        responses = self.monitor.send_command(command)
+        # The device counts down from the event times on its own clock, so
+        # only changed events need sending
+        events_key = json.dumps(self._last_calendar_events, sort_keys=True)
+        if events_key == self._calendar_sent_key:
+            logger.debug("Calendar unchanged, not sent")
+            self._check_ended_meetings()
+            return None
 
-        for response in responses:
-            if response == "CALENDAR_OK":
-                logger.info("Synced calendar to device")
-                break
-        else:
-            logger.warning("No acknowledgment for calendar sync")
+        def on_reply(responses):
+            for response in responses:
+                if response == "CALENDAR_OK":
+                    logger.info("Synced calendar to device")
+                    self._calendar_sent_key = events_key
+                    break
+            else:
+                logger.warning("No acknowledgment for calendar sync")
+
+            # Check for ended meetings
+            self._check_ended_meetings()
 
-        # Check for ended meetings
-        self._check_ended_meetings()
+        return self.monitor.data_command("CALENDAR", data, streamable=True), on_reply
 
     def sync_weather(self):
         """Fetch weather data and send to device."""
+        self._send_request(self._weather_request())
+
+    def _weather_request(self):
+        """Fetch weather data; returns (command, on_reply) or None."""
         if not self.weather:
-            return
+            return None
 
         data = self.weather.get_current_and_forecast()
         if data is None:
             logger.warning("Failed to fetch weather data")
-            return
+            return None
 
-        weather_json = json.dumps(data, separators=(",", ":"))
-        command = f"WEATHER:{weather_json}"
-        responses = self.monitor.send_command(command)
+        def on_reply(responses):
+            for response in responses:
+                if response == "WEATHER_OK":
+                    logger.info("Synced weather to device")
+                    return
+            logger.warning("No acknowledgment for weather sync")
 
-        for response in responses:
-            if response == "WEATHER_OK":
-                logger.info("Synced weather to device")
-                return
-        logger.warning("No acknowledgment for weather sync")
+        return self.monitor.data_command("WEATHER", data), on_reply
 
     def sync_jira_issues(self):
-        """Fetch assigned Jira issues and send to device."""
+        """Fetch assigned Jira issues and send them to the device.
+
+        After the device has acknowledged a list, later syncs send only a
+        JIRA_PATCH delta against that version. A full JIRA_PROJECTS list is
+        sent on first sync or if the device rejects the patch.
+        """
         if not self.jira:
             return
 
@@ -527,35 +1173,314 @@ class FocusKnobSync:
             logger.warning("No Jira issues fetched")
             return
 
-        issues_json = json.dumps(issues, separators=(",", ":"))
-        command = f"JIRA_PROJECTS:{issues_json}"
-        responses = self.monitor.send_command(command)
+        if self._jira_acked_ver is not None and self._send_jira_patch(issues):
+            return
 
-        for response in responses:
-            if response == "JIRA_PROJECTS_OK":
-                logger.info(f"Synced {len(issues)} Jira issues to device")
+        self._send_request(self._jira_projects_request(issues))
+
+    def _jira_projects_request(self, issues: Optional[list] = None):
+        """Full Jira issue list; returns (command, on_reply) or None."""
+        if issues is None:
+            if not self.jira:
+                return None
+            issues = self.jira.get_my_issues()
+            if not issues:
+                logger.warning("No Jira issues fetched")
+                return None
+
+        if self.monitor.jira_paging:
+            command, first = self._jira_page(issues, 0)
+        if self.monitor.jira_paging and len(first) < len(issues):
+            # First page only - the device asks for more as the user browses
+            def on_page_reply(responses):
+                if self._jira_page_sent(issues, 0, first, responses):
+                    logger.info(f"Synced first {len(first)} of {len(issues)} Jira issues to device")
+                    return
+                if any(r.startswith("JIRA_PAGE_ERR:") for r in responses):
+                    self._jira_acked_ver = None
+                    if self._send_jira_page(issues, 0, len(first) // 2):
+                        return
+                logger.warning("No acknowledgment for Jira issues sync")
+                self._jira_acked_ver = None
+
+            return command, on_page_reply
+
+        def on_reply(responses):
+            if self._jira_projects_sent(issues, responses):
                 return
-        logger.warning("No acknowledgment for Jira issues sync")
+            for response in responses:
+                if response.startswith("JIRA_PROJECTS_ERR:"):
+                    self._jira_acked_ver = None
+                    if self._resend_jira_projects(issues, response[18:]):
+                        return
+            logger.warning("No acknowledgment for Jira issues sync")
+            self._jira_acked_ver = None
+
+        return self.monitor.data_command("JIRA_PROJECTS", issues, streamable=True), on_reply
+
+    def _jira_projects_sent(self, issues: list, responses: List[str]) -> bool:
+        """Record a full list as acknowledged if the device took it.
+
+        JIRA_PROJECTS_ERR:FULL:<n> means the device kept only the first n
+        issues; those count as acknowledged and later patches cover just them.
+        """
+        loaded = len(issues)
+        if "JIRA_PROJECTS_OK" not in responses:
+            full = [r for r in responses if r.startswith("JIRA_PROJECTS_ERR:FULL:")]
+            try:
+                loaded = int(full[0][23:])
+            except (IndexError, ValueError):
+                return False
+            logger.warning(f"Device had room for {loaded} of {len(issues)} Jira issues")
+        else:
+            logger.info(f"Synced {len(issues)} Jira issues to device")
+        self._jira_acked = {i["key"]: i for i in issues[:loaded]}
+        self._jira_acked_ver = 0
+        self._jira_issues = issues
+        return True
+
+    def _resend_jira_projects(self, issues: list, reason: str) -> bool:
+        """Retry a full list the device could not parse.
+
+        A list too large for the device's parse document goes as a stream,
+        parsed record by record, or failing that as a shorter list; an
+        unreadable one is sent once more as it was.
+        """
+        if reason != "TOO_LARGE":
+            logger.warning(f"Device could not read the Jira issue list ({reason}) - resending")
+            command = self.monitor.data_command("JIRA_PROJECTS", issues, streamable=True)
+            return self._jira_projects_sent(issues, self.monitor.send_command(command))
+        if self.monitor.stream:
+            logger.warning("Jira issue list too large to parse on the device - streaming it")
+            text = json.dumps(issues, separators=(',', ':'))
+            return self._jira_projects_sent(
+                issues, self.monitor.send_command(f"JIRA_PROJECTS_STREAM:{text}"))
+        sent = issues
+        while len(sent) > 1:
+            sent = sent[:len(sent) // 2]
+            logger.warning(f"Jira issue list too large for the device - sending the first {len(sent)}")
+            responses = self.monitor.send_command(self.monitor.data_command("JIRA_PROJECTS", sent))
+            if self._jira_projects_sent(sent, responses):
+                return True
+            if "JIRA_PROJECTS_ERR:TOO_LARGE" not in responses:
+                break
+        return False
+
+    def _jira_page_sent(self, issues: list, offset: int, page_issues: list,
+                        responses: List[str]) -> bool:
+        """Record a page as acknowledged if the device took it.
+
+        JIRA_PAGE_ERR:<n>:FULL means the device ran out of room after n
+        issues; the part it kept counts and it asks for no more pages.
+        """
+        if not any(r.startswith("JIRA_PAGE_OK:") for r in responses):
+            full = [r for r in responses
+                    if r.startswith("JIRA_PAGE_ERR:") and r.endswith(":FULL")]
+            try:
+                loaded = int(full[0].split(":")[1])
+            except (IndexError, ValueError):
+                return False
+            logger.warning(f"Device had room for {loaded} of {len(issues)} Jira issues")
+            page_issues = page_issues[:max(0, loaded - offset)]
+        if offset == 0:
+            self._jira_acked = {}
+            self._jira_acked_ver = 0
+            self._jira_issues = issues
+        self._jira_acked.update({i["key"]: i for i in page_issues})
+        return True
+
+    def _jira_page(self, issues: list, offset: int, limit: Optional[int] = None):
+        """JIRA_PAGE_DATA for as many issues from offset as the device takes.
+
+        The page grows while its parsed form fits the device's Jira document
+        (jira_doc in HELLO) and the command fits its buffer (batch_max); at
+        least one issue always goes. Returns (command, page_issues).
+        """
+        doc_max = self.monitor.device_info.get("jira_doc", JIRA_DOC_SIZE)
+        stop = len(issues) if limit is None else min(len(issues), offset + limit)
+        cost = json_doc_cost({"offset": offset, "total": len(issues), "issues": []})
+        end = offset
+        while end < stop:
+            cost += 16 + json_doc_cost(issues[end])
+            if end > offset and cost > doc_max:
+                break
+            end += 1
+
+        while True:
+            page_issues = issues[offset:end]
+            page = {"offset": offset, "total": len(issues), "issues": page_issues}
+            command = self.monitor.data_command("JIRA_PAGE_DATA", page)
+            size = len(wire_bytes(command))
+            if size <= self.monitor.batch_max or len(page_issues) <= 1:
+                return command, page_issues
+            # Long text encodes bigger than it parses - shrink by the overshoot
+            end = offset + max(1, min(len(page_issues) - 1,
+                                      len(page_issues) * self.monitor.batch_max // size))
+
+    def _send_jira_page(self, issues: list, offset: int, limit: Optional[int] = None) -> bool:
+        """Send issues from offset as one JIRA_PAGE_DATA.
+
+        A page the device cannot parse (JIRA_PAGE_ERR) is halved and sent
+        again, down to a single issue.
+        """
+        while limit is None or limit > 0:
+            command, page_issues = self._jira_page(issues, offset, limit)
+            responses = self.monitor.send_command(command)
+            if self._jira_page_sent(issues, offset, page_issues, responses):
+                logger.info(f"Sent Jira issues {offset}-{offset + len(page_issues)} "
+                            f"of {len(issues)}")
+                return True
+            if not any(r.startswith("JIRA_PAGE_ERR:") for r in responses):
+                logger.warning(f"Jira page at {offset} not accepted: {responses}")
+                return False
+            limit = len(page_issues) // 2
+            logger.warning(f"Device could not parse Jira page at {offset} - "
+                           f"retrying with {limit} issues")
+        return False
+
+    def handle_jira_page(self, payload: str):
+        """Handle JIRA_PAGE:<offset> from device - send the next page of issues."""
+        try:
+            offset = int(payload)
+        except ValueError:
+            logger.warning(f"Bad JIRA_PAGE request: {payload!r}")
+            return
+        if self._jira_acked_ver is None:
+            return  # Full list on its way anyway
+
+        self._send_jira_page(self._jira_issues, offset)
+
+    def _send_jira_patch(self, issues: list) -> bool:
+        """Send upserts/deletes relative to the last acknowledged list.
+
+        Returns False if the device needs a full list instead.
+        """
+        current = {i["key"]: i for i in issues}
+        paged = len(self._jira_acked) < len(self._jira_issues)
+        if paged:
+            # Device holds a prefix (paged, or the rest did not fit): patch
+            # only what it has loaded
+            current = {k: v for k, v in current.items() if k in self._jira_acked}
+        ops = []
+        for key in self._jira_acked:
+            if key not in current:
+                ops.append({"op": "d", "key": key})
+        for key, issue in current.items():
+            old = self._jira_acked.get(key)
+            if old != issue:
+                op = {"op": "u", "key": key}
+                op.update({k: v for k, v in issue.items()
+                           if k != "key" and (old is None or old.get(k) != v)})
+                ops.append(op)
+
+        if not ops:
+            logger.debug("Jira issues unchanged - nothing to send")
+            return True
+
+        ver = (self._jira_acked_ver + 1) & 0xFFFF
+        patch = {"base": self._jira_acked_ver, "ver": ver, "ops": ops}
+        if paged:
+            patch["total"] = len(issues)
+        responses = self.monitor.send_command(self.monitor.data_command("JIRA_PATCH", patch))
+
+        for response in responses:
+            if response == f"JIRA_PATCH_OK:{ver}":
+                logger.info(f"Patched {len(ops)} Jira issue(s) on device (v{ver})")
+                self._jira_acked = current
+                self._jira_acked_ver = ver
+                self._jira_issues = issues
+                return True
+            if response.startswith("JIRA_PATCH_ERR:"):
+                # FULL: the device stopped part way and waits for a full list
+                logger.warning(f"Device could not apply Jira patch ({response[15:]})")
+                break
+            if response.startswith("JIRA_PATCH_NAK:") or response.startswith("ERROR:"):
+                break
+
+        logger.info("Jira patch rejected - sending full list")
+        self._jira_acked_ver = None
+        return False
 
     def sync_jira_hours(self):
         """Fetch today's Jira hours and send to device."""
+        self._send_request(self._jira_hours_request())
+
+    def _jira_hours_request(self):
+        """Fetch today's Jira hours; returns (command, on_reply) or None."""
         if not self.jira:
-            return
+            return None
 
         hours_data = self.jira.get_today_worklogs()
         if hours_data is None:
             logger.warning("Failed to fetch Jira hours data")
+            return None
+
+        def on_reply(responses):
+            for response in responses:
+                if response == "JIRA_HOURS_OK":
+                    logger.info(f"Synced Jira hours: {hours_data.get('logged_min', 0)} min")
+                    return
+            logger.warning("No acknowledgment for Jira hours sync")
+
+        return self.monitor.data_command("JIRA_HOURS", hours_data), on_reply
+
+    def sync_on_connect(self, full: bool = True):
+        """Send GET_LOGS and every data sync in one pipelined batch.
+
+        All data is fetched first, then the device receives the commands
+        back-to-back and replies per request id, so the UI is populated
+        after roughly one transfer time. Without full (the device restored
+        the data last synced) only GET_LOGS is sent and the periodic syncs
+        carry on from where they were.
+        """
+        requests = [("GET_LOGS", self.process_responses)]
+        if full:
+            self._calendar_sent_key = None  # Device may have rebooted
+            for build in (self._jira_projects_request, self._weather_request,
+                          self._calendar_request, self._jira_hours_request):
+                request = build()
+                if request:
+                    requests.append(request)
+
+        start = time.time()
+        results = self.monitor.send_batch([command for command, _ in requests])
+        logger.info(f"Connect sync: {len(requests)} commands in {(time.time() - start) * 1000:.0f} ms")
+        for (_, on_reply), responses in zip(requests, results):
+            on_reply(responses)
+        if not full:
             return
 
-        hours_json = json.dumps(hours_data, separators=(",", ":"))
-        command = f"JIRA_HOURS:{hours_json}"
-        responses = self.monitor.send_command(command)
+        now = time.time()
+        self._last_jira_sync = now
+        self._last_weather_sync = now
+        self._last_calendar_sync = now
+        self._last_jira_hours_sync = now
+        self._record_snapshot()
 
-        for response in responses:
-            if response == "JIRA_HOURS_OK":
-                logger.info(f"Synced Jira hours: {hours_data.get('logged_min', 0)} min")
-                return
-        logger.warning("No acknowledgment for Jira hours sync")
+    def _confirm_snapshot(self) -> bool:
+        """True if the device warm-started from the data last synced to it.
+
+        The device's stale markers are cleared by the confirmation.
+        """
+        version = self.monitor.device_info.get("snapshot")
+        if not self._device_snapshot or version != self._device_snapshot:
+            return False
+        for response in self.monitor.send_command(f"SNAPSHOT:{version}"):
+            if response == f"SNAPSHOT:{version}":
+                logger.info(f"Device restored snapshot {version}, skipping data sync")
+                return True
+        return False
+
+    def _record_snapshot(self):
+        """Remember the device's snapshot version of the data just synced."""
+        self._device_snapshot = None
+        if "SNAPSHOT" not in self.monitor.device_info.get("caps", []):
+            return
+        for response in self.monitor.send_command("SNAPSHOT"):
+            if response.startswith("SNAPSHOT:"):
+                version = response.split(":", 1)[1]
+                if version.strip("0"):
+                    self._device_snapshot = version
 
     def _check_ended_meetings(self):
         """Check if any meetings have ended and prompt to log them."""
@@ -609,8 +1534,10 @@ class FocusKnobSync:
             # Mark as prompted
             self._prompted_meetings.add(meeting_key)
 
-            # Prompt user
-            self._prompt_meeting_log(title, duration_min)
+            # Prompt user; the device has no request in flight, so it
+            # learns the new total from a refresh
+            if self._prompt_meeting_log(title, duration_min):
+                self.sync_jira_hours()
 
     def _prompt_meeting_log(self, meeting_title: str, duration_min: int) -> bool:
         """Show popup asking user to log a meeting to Jira. Returns True on success."""
@@ -664,8 +1591,6 @@ class FocusKnobSync:
 
         if success:
             logger.info(f"Logged {duration_min}min meeting '{meeting_title}' to {issue_key}")
-            # Refresh hours display
-            self.sync_jira_hours()
             return True
         else:
             logger.error(f"Failed to log meeting to {issue_key}")
@@ -698,7 +1623,8 @@ class FocusKnobSync:
 
             success = self._prompt_meeting_log(meeting_title, duration_minutes)
             if success:
-                self.monitor.send_command("JIRA_LOG_OK")
+                # The device adds the minutes to today's hours itself
+                self.monitor.send_command(f"JIRA_LOG_OK:{duration_minutes}")
             else:
                 self.monitor.send_command("JIRA_LOG_ERROR:Cancelled or failed")
 
@@ -748,7 +1674,7 @@ class FocusKnobSync:
             success = self.jira.log_work(issue_key, time_spent_seconds, description)
 
             if success:
-                self.monitor.send_command("JIRA_LOG_OK")
+                self.monitor.send_command(f"JIRA_LOG_OK:{duration_minutes}")
                 logger.info(f"Logged {duration_minutes}min to {issue_key}: {description}")
             else:
                 self.monitor.send_command("JIRA_LOG_ERROR:Jira API error")
@@ -862,7 +1788,7 @@ class FocusKnobSync:
             success = self.jira.log_work(issue_key, time_spent_seconds, description)
 
             if success:
-                self.monitor.send_command("JIRA_LOG_OK")
+                self.monitor.send_command(f"JIRA_LOG_OK:{duration_minutes}")
                 logger.info(f"Manual log: {duration_minutes}min to {issue_key}: {description}")
             else:
                 self.monitor.send_command("JIRA_LOG_ERROR:Jira API error")
@@ -980,39 +1906,64 @@ class FocusKnobSync:
         except json.JSONDecodeError as e:
             logger.error(f"Invalid log JSON: {e}")
 
-    def handle_note(self, note_json: str):
-        """Handle NOTE response from device."""
+    def handle_note(self, note_line: str) -> Optional[int]:
+        """Handle NOTE:<id>:<json> from device.
+
+        Returns the note id to acknowledge, or None to leave it pending
+        (the device resends unacknowledged notes).
+        """
+        id_str, _, note_json = note_line.partition(":")
+        try:
+            note_id = int(id_str)
+        except ValueError:
+            logger.error(f"Invalid note id: {id_str!r}")
+            return None
+
+        # Resent after a lost ack - already in Notion
+        if note_id in self._notes_synced:
+            return note_id
+
         try:
             note_data = json.loads(note_json)
-            logger.info(f"Received note: {note_data.get('text', '')[:50]}...")
+            logger.info(f"Received note {note_id}: {note_data.get('text', '')[:50]}...")
 
-            if self.notion:
-                if self.notion.add_note(note_data):
-                    self.monitor.send_ok()
-                else:
-                    logger.error("Failed to sync note to Notion")
-            else:
-                # No Notion, just acknowledge
-                self.monitor.send_ok()
+            if self.notion and not self.notion.add_note(note_data):
+                logger.error("Failed to sync note to Notion")
+                return None
+
+            self._notes_synced.add(note_id)
+            return note_id
 
         except json.JSONDecodeError as e:
             logger.error(f"Invalid note JSON: {e}")
+            return None
 
     def process_responses(self, responses: List[str]):
         """Process responses from device."""
+        note_acks = []
         for response in responses:
             if response.startswith("LOG:"):
                 self.handle_log(response[4:])
             elif response.startswith("NOTE:"):
-                self.handle_note(response[5:])
+                note_id = self.handle_note(response[5:])
+                if note_id is not None:
+                    note_acks.append(note_id)
             elif response.startswith("JIRA_TIMER_DONE:"):
                 self.handle_jira_timer_done(response[16:])
             elif response.startswith("JIRA_LOG_TIME:"):
                 self.handle_jira_log_time(response[14:])
             elif response.startswith("JIRA_OPEN:"):
                 self.handle_jira_open(response[10:])
+            elif response.startswith("JIRA_PAGE:"):
+                self.handle_jira_page(response[10:])
             elif response == "JIRA_PROJECTS_OK":
                 logger.debug("Device acknowledged Jira projects")
+            elif response.startswith("JIRA_PROJECTS_ERR:"):
+                logger.warning(f"Device rejected Jira projects: {response[18:]}")
+            elif response.startswith(("JIRA_PATCH_OK:", "JIRA_PATCH_NAK:",
+                                      "JIRA_PATCH_ERR:", "JIRA_PAGE_OK:", "JIRA_PAGE_NAK:",
+                                      "JIRA_PAGE_ERR:")):
+                logger.debug(f"Device Jira patch reply: {response}")
             elif response == "WEATHER_OK":
                 logger.debug("Device acknowledged weather data")
             elif response == "CALENDAR_OK":
@@ -1023,13 +1974,19 @@ class FocusKnobSync:
                 self.handle_jira_log_meeting(response[17:])
             elif response.startswith("ERROR:"):
                 logger.error(f"Device error: {response[6:]}")
-            elif response in ["PONG", "TIME_OK", "OK", "READY:FocusKnob"]:
+            elif response in ["PONG", "TIME_OK", "OK", "READY:FocusKnob"] or response.startswith("HELLO:"):
+                pass  # Expected responses
+            elif response.startswith(("TIMESYNC:", "TIMEADJ_OK:")):
                 pass  # Expected responses
-            elif response.startswith("USBSync:") or response.startswith("TimeLog:"):
-                logger.debug(f"Device debug: {response}")
+            elif response.startswith(("ACK:", "NAK:", "FRAMED_OK:", "STATS:", "END:", "ENCODINGS:")):
+                pass  # Transport-level replies
             else:
                 logger.debug(f"Unknown response: {response}")
 
+        # One selective ack for the whole window
+        if note_acks:
+            self.monitor.send_line("NOTE_ACK:" + ",".join(str(i) for i in note_acks))
+
     def run(self):
         """Main service loop."""
         logger.info("FocusKnob Sync Service started")
@@ -1049,22 +2006,23 @@ class FocusKnobSync:
                                 "connected": True,
                                 "port": self.monitor.port_name,
                             })
+                            # Use the fastest transport the firmware supports
+                            self.monitor.negotiate()
+                            # A device that warm-started from the data last
+                            # synced keeps it; otherwise it may have rebooted
+                            # empty and the next Jira sync is a full list
+                            warm = self._confirm_snapshot()
+                            if not warm:
+                                self._jira_acked_ver = None
+                            self._notes_synced.clear()
                             # Initial time sync
-                            TimeSync.sync_time(self.monitor)
-                            # Request logs
-                            responses = self.monitor.send_command("GET_LOGS")
+                            responses = []
+                            TimeSync.sync_time(self.monitor, responses)
                             self.process_responses(responses)
-                            # Sync Jira projects to device
-                            self.sync_jira_issues()
-                            # Sync weather to device
-                            self.sync_weather()
-                            self._last_weather_sync = time.time()
-                            # Sync calendar to device
-                            self.sync_calendar()
-                            self._last_calendar_sync = time.time()
-                            # Sync Jira hours to device
-                            self.sync_jira_hours()
-                            self._last_jira_hours_sync = time.time()
+                            self._last_time_sync = time.time()
+                            # Logs, Jira projects, weather, calendar and
+                            # Jira hours as one pipelined batch
+                            self.sync_on_connect(full=not warm)
                             last_ping = time.time()
                     else:
                         time.sleep(POLL_INTERVAL)
@@ -1085,20 +2043,44 @@ class FocusKnobSync:
                             self.process_responses(responses)
                             last_ping = time.time()
 
+                    # Periodic clock sync - small offsets are slewed on the device
+                    if time.time() - self._last_time_sync >= TIME_RESYNC_INTERVAL:
+                        responses = []
+                        TimeSync.sync_time(self.monitor, responses)
+                        self.process_responses(responses)
+                        self._last_time_sync = time.time()
+
                     # Periodic weather refresh (every 15 minutes)
+                    synced = False
                     if self.weather and time.time() - self._last_weather_sync >= 900:
                         self.sync_weather()
                         self._last_weather_sync = time.time()
+                        synced = True
 
                     # Periodic calendar refresh (every 5 minutes)
                     if self.calendar and time.time() - self._last_calendar_sync >= 300:
                         self.sync_calendar()
                         self._last_calendar_sync = time.time()
-
-                    # Periodic Jira hours refresh (every 5 minutes)
-                    if self.jira and time.time() - self._last_jira_hours_sync >= 300:
+                        synced = True
+
+                    # Periodic Jira issue refresh (every 5 minutes, sent as a delta)
+                    if self.jira and time.time() - self._last_jira_sync >= 300:
+                        self.sync_jira_issues()
+                        self._last_jira_sync = time.time()
+                        synced = True
+
+                    # Periodic Jira hours refresh (every 5 minutes, or every
+                    # 30 when the device counts confirmed worklogs itself -
+                    # then only worklogs made elsewhere wait for this)
+                    hours_interval = 1800 if "LOG_MINUTES" in self.monitor.device_info.get("caps", []) else 300
+                    if self.jira and time.time() - self._last_jira_hours_sync >= hours_interval:
                         self.sync_jira_hours()
                         self._last_jira_hours_sync = time.time()
+                        synced = True
+
+                    # Track the device snapshot so a reboot can skip the next sync
+                    if synced:
+                        self._record_snapshot()
 
                     # Check for unsolicited messages — drain all available lines
                     lines = []
@@ -18,6 +18,8 @@ import requests
 
 logger = logging.getLogger(__name__)
 
+MAX_ISSUES = 1000  # device stores up to 1024 issues in PSRAM
+
 
 class JiraClient:
     """Handles Jira REST API interactions."""
@@ -185,10 +187,10 @@ class JiraClient:
 
         Returns [{key, name, proj, status, desc}, ...] where:
           key    = issue key (e.g. "DEMOCAI-44")
-          name   = issue summary, truncated to fit device buffer
+          name   = issue summary (device keeps up to 127 bytes)
           proj   = project name (e.g. "Democratized AI")
           status = status name (e.g. "In Progress")
-          desc   = first ~127 chars of description plain text
+          desc   = first ~255 chars of description plain text
         """
         try:
             jql = (
@@ -196,23 +198,30 @@ class JiraClient:
                 'AND statusCategory in ("To Do", "In Progress") '
                 "ORDER BY updated DESC"
             )
-            params = {
-                "jql": jql,
-                "maxResults": 20,
-                "fields": "summary,project,status,description",
-            }
-            response = requests.get(
-                f"{self.base_url}/rest/api/3/search/jql",
-                headers=self.headers,
-                auth=self.auth,
-                params=params,
-                timeout=15,
-            )
-            if response.status_code == 200:
+            result = []
+            next_token = None
+            # The device pages through the list, so fetch all of it (one
+            # API page per request, bounded by MAX_ISSUES)
+            while len(result) < MAX_ISSUES:
+                params = {
+                    "jql": jql,
+                    "maxResults": 100,
+                    "fields": "summary,project,status,description",
+                }
+                if next_token:
+                    params["nextPageToken"] = next_token
+                response = requests.get(
+                    f"{self.base_url}/rest/api/3/search/jql",
+                    headers=self.headers,
+                    auth=self.auth,
+                    params=params,
+                    timeout=15,
+                )
+                if response.status_code != 200:
+                    logger.error(f"Jira search API error: {response.status_code}")
+                    return result
                 data = response.json()
-                issues = data.get("issues", [])
-                result = []
-                for issue in issues:
+                for issue in data.get("issues", []):
                     key = issue["key"]
                     fields = issue["fields"]
                     summary = fields["summary"]
@@ -221,15 +230,10 @@ class JiraClient:
                     desc_adf = fields.get("description")
                     desc_text = self._adf_to_plain_text(desc_adf)
 
-                    # Truncate to fit device buffers (with null terminator)
-                    if len(summary) > 47:
-                        summary = summary[:44] + "..."
-                    if len(proj_name) > 23:
-                        proj_name = proj_name[:20] + "..."
-                    if len(status_name) > 15:
-                        status_name = status_name[:12] + "..."
-                    if len(desc_text) > 127:
-                        desc_text = desc_text[:124] + "..."
+                    # Device stores text in a shared arena; only the
+                    # description is cut to keep the list compact
+                    if len(desc_text) > 255:
+                        desc_text = desc_text[:252] + "..."
 
                     result.append({
                         "key": key,
@@ -238,11 +242,11 @@ class JiraClient:
                         "status": status_name,
                         "desc": desc_text,
                     })
-                logger.info(f"Fetched {len(result)} Jira issues for current user")
-                return result
-            else:
-                logger.error(f"Jira search API error: {response.status_code}")
-                return []
+                next_token = data.get("nextPageToken")
+                if data.get("isLast", True) or not next_token:
+                    break
+            logger.info(f"Fetched {len(result)} Jira issues for current user")
+            return result[:MAX_ISSUES]
         except Exception as e:
             logger.error(f"Failed to fetch Jira issues: {e}")
             return []
@@ -0,0 +1,52 @@
+#define LOG_TAG "DataBus"
+#include "data_bus.h"
+#include "debug_log.h"
+
+typedef struct {
+    uint32_t topics;
+    data_bus_fn fn;
+} subscriber_t;
+
+static subscriber_t g_subscribers[DATA_BUS_MAX_SUBSCRIBERS];
+static uint8_t g_subscriber_count = 0;
+
+static uint32_t g_generation[DATA_TOPIC_COUNT];
+static uint32_t g_pending = 0;
+
+void data_bus_publish(uint32_t topics) {
+    for (int i = 0; i < DATA_TOPIC_COUNT; i++) {
+        if (topics & (1u << i)) __atomic_add_fetch(&g_generation[i], 1, __ATOMIC_RELAXED);
+    }
+    // Release pairs with the exchange in dispatch: the store's update is
+    // visible to whoever sees the pending bit
+    __atomic_fetch_or(&g_pending, topics, __ATOMIC_RELEASE);
+}
+
+uint32_t data_bus_generation(uint32_t topic) {
+    for (int i = 0; i < DATA_TOPIC_COUNT; i++) {
+        if (topic == (1u << i)) return __atomic_load_n(&g_generation[i], __ATOMIC_RELAXED);
+    }
+    return 0;
+}
+
+bool data_bus_subscribe(uint32_t topics, data_bus_fn fn) {
+    if (g_subscriber_count >= DATA_BUS_MAX_SUBSCRIBERS) {
+        LOGE("Subscriber table full");
+        return false;
+    }
+    g_subscribers[g_subscriber_count].topics = topics;
+    g_subscribers[g_subscriber_count].fn = fn;
+    g_subscriber_count++;
+    return true;
+}
+
+uint32_t data_bus_dispatch(void) {
+    uint32_t pending = __atomic_exchange_n(&g_pending, 0, __ATOMIC_ACQUIRE);
+    if (!pending) return 0;
+
+    for (uint8_t i = 0; i < g_subscriber_count; i++) {
+        uint32_t topics = pending & g_subscribers[i].topics;
+        if (topics) g_subscribers[i].fn(topics);
+    }
+    return pending;
+}
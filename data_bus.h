@@ -0,0 +1,51 @@
+#ifndef DATA_BUS_H
+#define DATA_BUS_H
+
+/*
+ * Change notification bus between the data stores and the UI
+ *
+ * A store publishes its topic after every update that changes what the
+ * screens show; that bumps the topic's generation and marks it pending.
+ * The LVGL task calls data_bus_dispatch() from a timer and hands the
+ * pending topics to the subscribed screens, so widgets are only redrawn
+ * when their inputs changed. Publishing never blocks and works from any
+ * task; several updates before the next dispatch collapse into one.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Topics (bit mask)
+#define DATA_TOPIC_JIRA        (1u << 0)   // Issue list / selection text
+#define DATA_TOPIC_WEATHER     (1u << 1)
+#define DATA_TOPIC_CALENDAR    (1u << 2)
+#define DATA_TOPIC_JIRA_HOURS  (1u << 3)
+#define DATA_TOPIC_COUNT 4
+
+#define DATA_BUS_MAX_SUBSCRIBERS 8
+
+// Subscriber callback - topics holds the changed topics it subscribed to
+typedef void (*data_bus_fn)(uint32_t topics);
+
+// Mark topics changed (any task)
+void data_bus_publish(uint32_t topics);
+
+// Number of publications of one topic so far (0 = never updated)
+uint32_t data_bus_generation(uint32_t topic);
+
+// Call fn for changes to any of topics; false if the table is full.
+// Subscribe from the UI task before the dispatch timer starts.
+bool data_bus_subscribe(uint32_t topics, data_bus_fn fn);
+
+// Deliver pending topics to subscribers (UI task); returns the topics delivered
+uint32_t data_bus_dispatch(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DATA_BUS_H
@@ -0,0 +1,34 @@
+/*
+ * Debug Log Implementation
+ *
+ * Formats each message into a stack buffer and emits it with a single
+ * write under the USB sync TX lock, so it can't land inside a protocol
+ * line another task is writing.
+ */
+
+#include "debug_log.h"
+#include "usb_sync.h"
+#include <Arduino.h>
+#include <stdarg.h>
+
+#define DEBUG_LOG_LINE_MAX 160
+
+void debug_log_write(char level, const char* tag, const char* fmt, ...) {
+    char line[DEBUG_LOG_LINE_MAX];
+    int n = snprintf(line, sizeof(line), "#%c %s: ", level, tag);
+    if (n < 0) return;
+
+    va_list args;
+    va_start(args, fmt);
+    int m = vsnprintf(line + n, sizeof(line) - n, fmt, args);
+    va_end(args);
+    if (m < 0) return;
+
+    n += m;
+    if (n > (int)sizeof(line) - 2) n = sizeof(line) - 2;  // Truncated - keep room for newline
+    line[n++] = '\n';
+
+    usb_sync_tx_lock();
+    DEBUG_LOG_PORT.write((const uint8_t*)line, n);
+    usb_sync_tx_unlock();
+}
@@ -0,0 +1,84 @@
+#ifndef DEBUG_LOG_H
+#define DEBUG_LOG_H
+
+/*
+ * Leveled debug logging
+ *
+ * Debug text shares the USB CDC link with the sync protocol, so every log
+ * message goes out as one marked line:  #<level> <tag>: <message>
+ * The companion drops '#' lines before protocol parsing. Each line is one
+ * write under the USB sync TX lock (usb_sync_tx_lock()), which protocol
+ * lines are written under too, so neither splits the other.
+ *
+ * Levels above LOG_LOCAL_LEVEL compile to nothing, arguments included.
+ *
+ * Usage (per module, before the include):
+ *   #define LOG_TAG "USBSync"
+ *   #define LOG_LOCAL_LEVEL DEBUG_LOG_DEBUG   // optional per-module override
+ *   #include "debug_log.h"
+ *   LOGI("Loaded %d projects", count);
+ */
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define DEBUG_LOG_NONE  0
+#define DEBUG_LOG_ERROR 1
+#define DEBUG_LOG_WARN  2
+#define DEBUG_LOG_INFO  3
+#define DEBUG_LOG_DEBUG 4
+
+// Global level - override with -DDEBUG_LOG_LEVEL=...
+#ifndef DEBUG_LOG_LEVEL
+#define DEBUG_LOG_LEVEL DEBUG_LOG_WARN
+#endif
+
+// Output stream - set to Serial0 to move logs off the USB sync link entirely
+#ifndef DEBUG_LOG_PORT
+#define DEBUG_LOG_PORT Serial
+#endif
+
+#ifndef LOG_LOCAL_LEVEL
+#define LOG_LOCAL_LEVEL DEBUG_LOG_LEVEL
+#endif
+
+#ifndef LOG_TAG
+#define LOG_TAG "?"
+#endif
+
+// Format and write one marked log line
+void debug_log_write(char level, const char* tag, const char* fmt, ...)
+    __attribute__((format(printf, 3, 4)));
+
+#if LOG_LOCAL_LEVEL >= DEBUG_LOG_ERROR
+#define LOGE(fmt, ...) debug_log_write('E', LOG_TAG, fmt, ##__VA_ARGS__)
+#else
+#define LOGE(fmt, ...) do {} while (0)
+#endif
+
+#if LOG_LOCAL_LEVEL >= DEBUG_LOG_WARN
+#define LOGW(fmt, ...) debug_log_write('W', LOG_TAG, fmt, ##__VA_ARGS__)
+#else
+#define LOGW(fmt, ...) do {} while (0)
+#endif
+
+#if LOG_LOCAL_LEVEL >= DEBUG_LOG_INFO
+#define LOGI(fmt, ...) debug_log_write('I', LOG_TAG, fmt, ##__VA_ARGS__)
+#else
+#define LOGI(fmt, ...) do {} while (0)
+#endif
+
+#if LOG_LOCAL_LEVEL >= DEBUG_LOG_DEBUG
+#define LOGD(fmt, ...) debug_log_write('D', LOG_TAG, fmt, ##__VA_ARGS__)
+#else
+#define LOGD(fmt, ...) do {} while (0)
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DEBUG_LOG_H
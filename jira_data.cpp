@@ -1,70 +1,699 @@
+#define LOG_TAG "JiraData"
 #include "jira_data.h"
+#include "debug_log.h"
+#include "usb_sync.h"
+#include "json_stream.h"
+#include "json_arena.h"
+#include "data_bus.h"
+#include "warm_start.h"
 #include <Arduino.h>
 #include <ArduinoJson.h>
+#include <esp_heap_caps.h>
 #include <string.h>
 
+#if JIRA_DOC_SIZE > JSON_ARENA_SIZE
+#error "JIRA_DOC_SIZE must fit the JSON arena"
+#endif
+
 static jira_state_t g_jira_state;
 
+// Key hash per loaded issue, in internal RAM so lookups don't walk PSRAM
+static uint32_t* g_key_hash = NULL;
+
+// Recency stamp per loaded issue: list positions count down from
+// RECENCY_BASE (the companion sends newest first), issues a patch changes
+// count up from it
+#define RECENCY_BASE 0x80000000UL
+static uint32_t* g_recency = NULL;
+static uint32_t g_recency_clock = 0;
+
+// Sort and group index of one view, rebuilt by build_views() each sync.
+// JIRA_VIEW_LIST is the list itself and has none.
+typedef struct {
+    uint16_t* order;        // View position -> issue index
+    uint16_t* rank;         // Issue index -> view position
+    uint16_t* group_start;  // First view position of each group
+    uint16_t group_count;   // 0 for views without groups
+} view_index_t;
+static view_index_t g_views[JIRA_VIEW_COUNT];
+static jira_view_t g_sort_view;  // View compare_issues() sorts for
+
+// Search index, rebuilt with the views: exact keys in an open-addressed
+// table, and for each trigram hash bucket the ascending indices of the
+// issues whose key or summary contains one of its trigrams
+#define SEARCH_BUCKETS (1u << JIRA_SEARCH_BUCKET_BITS)
+#define SEARCH_MIN_QUERY 3
+static uint16_t* g_key_table = NULL;      // Issue index + 1 per slot, 0 = empty
+static uint16_t g_key_table_mask = 0;
+static uint32_t* g_gram_start = NULL;     // SEARCH_BUCKETS + 1 offsets into g_postings
+static uint16_t* g_postings = NULL;
+static uint32_t g_postings_size = 0;
+static bool g_search_indexed = false;     // Postings fit - otherwise find scans
+static uint8_t g_gram_seen[SEARCH_BUCKETS / 8];
+static uint16_t g_grams[2 * JIRA_FIELD_MAX];
+
+// Issue text arena (PSRAM when present) - strings are appended, never freed;
+// a full list starts it over and a patch compacts it when it fills up
+static char* g_strings = NULL;
+static uint32_t g_strings_size = 0;
+static uint32_t g_strings_used = 0;
+
+// The selected issue was touched by the last jira_data_apply_patch()
+static bool g_patch_selected_changed = false;
+
+// Outstanding JIRA_PAGE request (0 = none)
+static uint32_t g_page_requested_ms = 0;
+// The last list ran out of records or string space - no more pages are
+// asked for until a full list starts over
+static bool g_store_full = false;
+
+// Seqlock over the list: odd while the parser task rewrites loaded issues
+// in place. The store is too big to double-buffer, so readers copy what
+// they need and retry (jira_data_read_selected).
+static uint32_t g_jira_seq = 0;
+
+static void list_write_begin(void) {
+    __atomic_store_n(&g_jira_seq, g_jira_seq + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+}
+
+static void list_write_end(void) {
+    __atomic_store_n(&g_jira_seq, g_jira_seq + 1, __ATOMIC_RELEASE);
+}
+
+// Start a read: false (after yielding) while the writer is mid-update
+static bool list_read_begin(uint32_t* seq) {
+    *seq = __atomic_load_n(&g_jira_seq, __ATOMIC_ACQUIRE);
+    if (*seq & 1) {
+        vTaskDelay(1);  // Let the parser task finish
+        return false;
+    }
+    return true;
+}
+
+// True if nothing was written since list_read_begin()
+static bool list_read_end(uint32_t seq) {
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    return __atomic_load_n(&g_jira_seq, __ATOMIC_RELAXED) == seq;
+}
+
+static void handle_jira_projects_command(const char* payload);
+static void handle_jira_patch_command(const char* payload);
+static void handle_jira_page_data_command(const char* payload);
+static void handle_jira_find_command(const char* payload);
+static void projects_stream_begin(void);
+static void projects_stream_feed(const char* data, size_t len);
+static void projects_stream_end(bool complete);
+
+// JIRA_PROJECTS_STREAM:<json> - same list, stored record by record as it arrives
+static const usb_sync_stream_t g_projects_stream_cmd = {
+    projects_stream_begin, projects_stream_feed, projects_stream_end
+};
+static json_stream_t g_projects_stream;
+static uint16_t g_stream_count = 0;
+static uint16_t g_stream_records = 0;  // Records in the stream, stored or not
+static bool g_stream_full = false;     // Records or string arena ran out mid-stream
+
+// Allocate from PSRAM, falling back to internal RAM
+static void* alloc_psram(size_t size) {
+    void* p = heap_caps_malloc(size, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    return p ? p : malloc(size);
+}
+
 void jira_data_init(void) {
     memset(&g_jira_state, 0, sizeof(g_jira_state));
     g_jira_state.selected_index = -1;
     g_jira_state.synced = false;
-    Serial.println("JiraData: Initialized");
+
+    // Full size only with PSRAM - internal RAM gets the small store
+    bool psram = heap_caps_get_free_size(MALLOC_CAP_SPIRAM) > JIRA_STRING_ARENA_SIZE;
+    uint16_t capacity = psram ? JIRA_MAX_PROJECTS : JIRA_MAX_PROJECTS_INTERNAL;
+    g_strings_size = psram ? JIRA_STRING_ARENA_SIZE : JIRA_STRING_ARENA_INTERNAL;
+
+    g_jira_state.projects = (jira_project_t*)alloc_psram(capacity * sizeof(jira_project_t));
+    g_key_hash = (uint32_t*)heap_caps_malloc(capacity * sizeof(uint32_t), MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    g_strings = (char*)alloc_psram(g_strings_size);
+    g_recency = (uint32_t*)alloc_psram(capacity * sizeof(uint32_t));
+    if (!g_jira_state.projects || !g_key_hash || !g_strings || !g_recency) {
+        LOGE("No memory for issue store");
+        free(g_jira_state.projects);
+        free(g_key_hash);
+        free(g_strings);
+        free(g_recency);
+        g_jira_state.projects = NULL;
+        g_key_hash = NULL;
+        g_strings = NULL;
+        g_recency = NULL;
+        capacity = 0;
+        g_strings_size = 0;
+    }
+
+    // Sorted views and the search index are optional: without them the
+    // knob walks list order and find scans
+    uint16_t* views = NULL;
+    if (capacity) {
+        views = (uint16_t*)alloc_psram(capacity * sizeof(uint16_t) * 3 * (JIRA_VIEW_COUNT - 1));
+        if (!views) LOGW("No memory for sorted views, list order only");
+    }
+    for (int v = JIRA_VIEW_LIST + 1; views && v < JIRA_VIEW_COUNT; v++) {
+        g_views[v].order = views;
+        g_views[v].rank = views + capacity;
+        g_views[v].group_start = views + 2 * capacity;
+        views += 3 * capacity;
+    }
+    // Key table at under half load; one posting per indexed text byte is
+    // plenty, since descriptions (most of the arena) are not indexed
+    uint32_t slots = 1;
+    while (slots < 2u * capacity) slots <<= 1;
+    g_key_table_mask = slots - 1;
+    g_postings_size = g_strings_size / sizeof(uint16_t);
+    if (capacity) {
+        g_key_table = (uint16_t*)alloc_psram(slots * sizeof(uint16_t));
+        g_gram_start = (uint32_t*)alloc_psram((SEARCH_BUCKETS + 1) * sizeof(uint32_t));
+        g_postings = (uint16_t*)alloc_psram(g_postings_size * sizeof(uint16_t));
+        if (!g_key_table || !g_gram_start || !g_postings) {
+            LOGW("No memory for search index, find will scan");
+            free(g_key_table);
+            free(g_gram_start);
+            free(g_postings);
+            g_key_table = NULL;
+            g_gram_start = NULL;
+            g_postings = NULL;
+        }
+    }
+    g_jira_state.capacity = capacity;
+    g_strings_used = 0;
+    LOGI("Initialized, %u issues / %u string bytes%s", capacity,
+         (unsigned)g_strings_size, psram ? " in PSRAM" : "");
+
+    usb_sync_register_command("JIRA_PROJECTS", handle_jira_projects_command);
+    usb_sync_register_command("JIRA_PATCH", handle_jira_patch_command);
+    usb_sync_register_command("JIRA_PAGE_DATA", handle_jira_page_data_command);
+    usb_sync_register_command("JIRA_FIND", handle_jira_find_command);
+    usb_sync_register_stream("JIRA_PROJECTS_STREAM", &g_projects_stream_cmd);
 }
 
-void jira_data_set_projects(const char* json) {
-    StaticJsonDocument<6144> doc;
-    DeserializationError err = deserializeJson(doc, json);
+// FNV-1a over an issue key
+static uint32_t key_hash(const char* key) {
+    uint32_t h = 2166136261UL;
+    for (const char* p = key; *p; p++) {
+        h ^= (uint8_t)*p;
+        h *= 16777619UL;
+    }
+    return h;
+}
 
-    if (err) {
-        Serial.printf("JiraData: JSON parse error: %s\n", err.c_str());
-        return;
+// Copy up to max bytes of src into the string arena. Empty strings share
+// one literal. Returns NULL if the arena is full.
+static const char* str_store(const char* src, size_t max) {
+    size_t len = strnlen(src, max);
+    if (len == 0) return "";
+    if (len + 1 > g_strings_size - g_strings_used) return NULL;
+
+    char* dst = g_strings + g_strings_used;
+    memcpy(dst, src, len);
+    dst[len] = '\0';
+    g_strings_used += len + 1;
+    return dst;
+}
+
+// Rebuild the arena with only the strings live entries point at, dropping
+// the ones patches replaced or deleted. Works from a temporary copy.
+static bool str_compact(void) {
+    uint32_t before = g_strings_used;
+    char* old = (char*)alloc_psram(before);
+    if (!old) return false;
+    memcpy(old, g_strings, before);
+
+    g_strings_used = 0;
+    for (uint16_t i = 0; i < g_jira_state.project_count; i++) {
+        jira_project_t* p = &g_jira_state.projects[i];
+        const char** fields[] = { &p->key, &p->name, &p->proj, &p->status, &p->desc };
+        for (size_t f = 0; f < sizeof(fields) / sizeof(fields[0]); f++) {
+            const char* s = *fields[f];
+            if (s < g_strings || s >= g_strings + before) continue;  // Shared ""
+            *fields[f] = str_store(old + (s - g_strings), JIRA_DESC_MAX);
+        }
     }
+    free(old);
+    LOGI("Compacted strings %u -> %u bytes", (unsigned)before, (unsigned)g_strings_used);
+    return true;
+}
 
-    JsonArray arr = doc.as<JsonArray>();
+// Fill one list entry from a project object; false if the arena is full
+static bool store_project(uint16_t index, JsonObject obj) {
+    jira_project_t* entry = &g_jira_state.projects[index];
+    entry->key = str_store(obj["key"] | "", JIRA_FIELD_MAX);
+    entry->name = str_store(obj["name"] | "", JIRA_FIELD_MAX);
+    entry->proj = str_store(obj["proj"] | "", JIRA_FIELD_MAX);
+    entry->status = str_store(obj["status"] | "", JIRA_FIELD_MAX);
+    entry->desc = str_store(obj["desc"] | "", JIRA_DESC_MAX);
+
+    if (!entry->key || !entry->name || !entry->proj || !entry->status || !entry->desc) {
+        LOGW("String arena full");
+        return false;
+    }
+    g_key_hash[index] = key_hash(entry->key);
+    g_recency[index] = RECENCY_BASE - 1 - index;
+    return true;
+}
+
+static int find_by_key(const char* key) {
+    uint32_t h = key_hash(key);
+    for (int i = 0; i < g_jira_state.project_count; i++) {
+        if (g_key_hash[i] == h &&
+            strncmp(g_jira_state.projects[i].key, key, JIRA_FIELD_MAX) == 0) return i;
+    }
+    return -1;
+}
+
+// Drop every loaded issue and its text
+static void clear_projects(void) {
     g_jira_state.project_count = 0;
+    g_strings_used = 0;
+    g_recency_clock = 0;
+    g_page_requested_ms = 0;
+    g_store_full = false;
+}
 
-    for (JsonObject obj : arr) {
-        if (g_jira_state.project_count >= JIRA_MAX_PROJECTS) break;
+static uint8_t status_rank(const char* status) {
+    if (strstr(status, "Progress") || strstr(status, "progress")) return 0;
+    if (strstr(status, "To Do") || strstr(status, "Hold")) return 1;
+    return 2;
+}
+
+// Text an issue is grouped by in view, NULL if the view has no groups
+static const char* group_key(jira_view_t view, uint16_t index) {
+    const jira_project_t* p = &g_jira_state.projects[index];
+    if (view == JIRA_VIEW_STATUS) return p->status;
+    if (view == JIRA_VIEW_PROJECT) return p->proj;
+    return NULL;
+}
+
+// qsort order of two issue indices in g_sort_view: by group, newest first
+static int compare_issues(const void* a, const void* b) {
+    uint16_t ia = *(const uint16_t*)a;
+    uint16_t ib = *(const uint16_t*)b;
+    const char* ka = group_key(g_sort_view, ia);
+    if (ka) {
+        const char* kb = group_key(g_sort_view, ib);
+        int d = strcmp(ka, kb);
+        if (d != 0) {
+            if (g_sort_view == JIRA_VIEW_STATUS) {
+                int r = status_rank(ka) - status_rank(kb);
+                if (r != 0) return r;
+            }
+            return d;
+        }
+    }
+    if (g_recency[ia] == g_recency[ib]) return 0;
+    return g_recency[ia] > g_recency[ib] ? -1 : 1;
+}
+
+// Sort every view and split it into groups - once per list change, so the
+// knob only looks positions up. Called inside list_write_begin/end.
+static void build_views(void) {
+    uint16_t n = g_jira_state.project_count;
+    for (int v = JIRA_VIEW_LIST + 1; v < JIRA_VIEW_COUNT; v++) {
+        view_index_t* vi = &g_views[v];
+        if (!vi->order) return;
+        for (uint16_t i = 0; i < n; i++) vi->order[i] = i;
+        g_sort_view = (jira_view_t)v;
+        qsort(vi->order, n, sizeof(uint16_t), compare_issues);
+
+        vi->group_count = 0;
+        const char* prev = NULL;
+        for (uint16_t pos = 0; pos < n; pos++) {
+            uint16_t i = vi->order[pos];
+            vi->rank[i] = pos;
+            const char* key = group_key(g_sort_view, i);
+            if (key && (!prev || strcmp(key, prev) != 0)) {
+                vi->group_start[vi->group_count++] = pos;
+            }
+            prev = key;
+        }
+    }
+}
+
+static inline uint8_t fold(char c) {
+    return (c >= 'A' && c <= 'Z') ? c + ('a' - 'A') : (uint8_t)c;
+}
 
-        const char* key = obj["key"] | "";
-        const char* name = obj["name"] | "";
-        const char* proj = obj["proj"] | "";
-        const char* status = obj["status"] | "";
-        const char* desc = obj["desc"] | "";
+static uint16_t trigram_bucket(const char* s) {
+    uint32_t h = ((uint32_t)fold(s[0]) << 16) | ((uint32_t)fold(s[1]) << 8) | fold(s[2]);
+    return (uint32_t)(h * 2654435761UL) >> (32 - JIRA_SEARCH_BUCKET_BITS);
+}
 
-        jira_project_t *entry = &g_jira_state.projects[g_jira_state.project_count];
+// Distinct trigram buckets of text into grams[n...]; returns the new n
+static uint16_t add_trigrams(const char* text, uint16_t n) {
+    for (const char* s = text; s[0] && s[1] && s[2]; s++) {
+        uint16_t b = trigram_bucket(s);
+        if (g_gram_seen[b >> 3] & (1 << (b & 7))) continue;
+        g_gram_seen[b >> 3] |= 1 << (b & 7);
+        g_grams[n++] = b;
+    }
+    return n;
+}
 
-        strncpy(entry->key, key, JIRA_KEY_LEN - 1);
-        entry->key[JIRA_KEY_LEN - 1] = '\0';
+// Distinct trigram buckets of an issue's key and summary into g_grams
+static uint16_t issue_trigrams(uint16_t index) {
+    const jira_project_t* p = &g_jira_state.projects[index];
+    uint16_t n = add_trigrams(p->name, add_trigrams(p->key, 0));
+    for (uint16_t k = 0; k < n; k++) g_gram_seen[g_grams[k] >> 3] = 0;
+    return n;
+}
 
-        strncpy(entry->name, name, JIRA_NAME_LEN - 1);
-        entry->name[JIRA_NAME_LEN - 1] = '\0';
+// Rebuild the key table and trigram postings. Postings are counted per
+// bucket first, then filled back to front so each list comes out ascending.
+// Called inside list_write_begin/end.
+static void build_search(void) {
+    g_search_indexed = false;
+    if (!g_key_table) return;
+    uint16_t n = g_jira_state.project_count;
 
-        strncpy(entry->proj, proj, JIRA_PROJ_LEN - 1);
-        entry->proj[JIRA_PROJ_LEN - 1] = '\0';
+    memset(g_key_table, 0, (g_key_table_mask + 1) * sizeof(uint16_t));
+    for (uint16_t i = 0; i < n; i++) {
+        uint32_t slot = g_key_hash[i] & g_key_table_mask;
+        while (g_key_table[slot]) slot = (slot + 1) & g_key_table_mask;
+        g_key_table[slot] = i + 1;
+    }
 
-        strncpy(entry->status, status, JIRA_STATUS_LEN - 1);
-        entry->status[JIRA_STATUS_LEN - 1] = '\0';
+    memset(g_gram_start, 0, (SEARCH_BUCKETS + 1) * sizeof(uint32_t));
+    for (uint16_t i = 0; i < n; i++) {
+        uint16_t grams = issue_trigrams(i);
+        for (uint16_t k = 0; k < grams; k++) g_gram_start[g_grams[k]]++;
+    }
+    uint32_t total = 0;
+    for (uint32_t b = 0; b < SEARCH_BUCKETS; b++) {
+        total += g_gram_start[b];
+        g_gram_start[b] = total;
+    }
+    g_gram_start[SEARCH_BUCKETS] = total;
+    if (total > g_postings_size) {
+        LOGW("Search index needs %u postings, has %u - find will scan",
+             (unsigned)total, (unsigned)g_postings_size);
+        return;
+    }
+    for (int i = n - 1; i >= 0; i--) {
+        uint16_t grams = issue_trigrams(i);
+        for (uint16_t k = 0; k < grams; k++) g_postings[--g_gram_start[g_grams[k]]] = i;
+    }
+    g_search_indexed = true;
+}
 
-        strncpy(entry->desc, desc, JIRA_DESC_LEN - 1);
-        entry->desc[JIRA_DESC_LEN - 1] = '\0';
+// Sort, group and search indices - once per list change
+static void build_indexes(void) {
+    build_views();
+    build_search();
+}
 
+// Append the issues of arr after the loaded ones, skipping keys already
+// loaded (the companion's list may have shifted between pages). Returns
+// false, and sets g_store_full, if the records or the string arena ran out
+// before the end of arr.
+static bool append_projects(JsonArray arr) {
+    for (JsonObject obj : arr) {
+        if (find_by_key(obj["key"] | "") >= 0) continue;
+        if (g_jira_state.project_count >= g_jira_state.capacity ||
+            !store_project(g_jira_state.project_count, obj)) {
+            g_store_full = true;
+            return false;
+        }
         g_jira_state.project_count++;
     }
+    return true;
+}
+
+// TOO_LARGE tells the companion to send less at once; INVALID to resend
+static jira_store_result_t parse_result(DeserializationError err) {
+    return err == DeserializationError::NoMemory ? JIRA_STORE_TOO_LARGE : JIRA_STORE_INVALID;
+}
+
+static const char* store_result_name(jira_store_result_t result) {
+    switch (result) {
+        case JIRA_STORE_TOO_LARGE: return "TOO_LARGE";
+        case JIRA_STORE_FULL:      return "FULL";
+        default:                   return "INVALID";
+    }
+}
+
+jira_store_result_t jira_data_set_projects(const char* json) {
+    ArenaJsonDocument doc(JIRA_DOC_SIZE);
+    DeserializationError err = usb_sync_parse_payload(doc, json);
+
+    if (err) {
+        LOGW("JSON parse error: %s", err.c_str());
+        return parse_result(err);
+    }
+    if (!doc.is<JsonArray>()) {
+        LOGW("Project list is not an array");
+        return JIRA_STORE_INVALID;
+    }
+
+    JsonArray arr = doc.as<JsonArray>();
+    list_write_begin();
+    clear_projects();
+    bool complete = append_projects(arr);
+    // Short of the list size when it did not all fit
+    g_jira_state.total = complete ? g_jira_state.project_count : arr.size();
 
     g_jira_state.synced = true;
+    g_jira_state.version = 0;
+    build_indexes();
+    list_write_end();
 
     // Start on dashboard (index -1) — user turns knob to browse issues
 
-    Serial.printf("JiraData: Loaded %d projects\n", g_jira_state.project_count);
+    LOGI("Loaded %d of %d projects, %u string bytes", g_jira_state.project_count,
+         g_jira_state.total, (unsigned)g_strings_used);
+    return complete ? JIRA_STORE_OK : JIRA_STORE_FULL;
+}
+
+jira_store_result_t jira_data_add_page(const char* json) {
+    ArenaJsonDocument doc(JIRA_DOC_SIZE);
+    DeserializationError err = usb_sync_parse_payload(doc, json);
+
+    if (err) {
+        LOGW("Page parse error: %s", err.c_str());
+        return parse_result(err);
+    }
+    if (!doc["issues"].is<JsonArray>()) {
+        LOGW("Page has no issue array");
+        return JIRA_STORE_INVALID;
+    }
+
+    uint16_t offset = doc["offset"] | 0;
+    if (offset != 0 && (!g_jira_state.synced || offset != g_jira_state.project_count)) {
+        LOGW("Page at %u, have %u", offset, g_jira_state.project_count);
+        return JIRA_STORE_MISALIGNED;
+    }
+
+    list_write_begin();
+    if (offset == 0) {
+        clear_projects();
+        g_jira_state.synced = true;
+        g_jira_state.version = 0;
+    }
+
+    bool complete = append_projects(doc["issues"].as<JsonArray>());
+    g_jira_state.total = doc["total"] | g_jira_state.project_count;
+    if (g_jira_state.total < g_jira_state.project_count) {
+        g_jira_state.total = g_jira_state.project_count;
+    }
+    build_indexes();
+    list_write_end();
+    g_page_requested_ms = 0;
+
+    LOGI("Page at %u -> %u of %u projects, %u string bytes", offset,
+         g_jira_state.project_count, g_jira_state.total, (unsigned)g_strings_used);
+    // Out of room: has_more() stays false so the same page isn't asked for again
+    return complete ? JIRA_STORE_OK : JIRA_STORE_FULL;
+}
+
+// Point a field at a copy of src, compacting the arena if it is full.
+// Sets *changed if the value differs; returns false if it still won't fit.
+static bool update_field(const char** field, const char* src, size_t max, bool* changed) {
+    if (strncmp(*field, src, max) == 0) return true;
+    const char* stored = str_store(src, max);
+    if (!stored) {
+        if (!str_compact()) return false;
+        stored = str_store(src, max);
+        if (!stored) return false;
+    }
+    *field = stored;
+    *changed = true;
+    return true;
+}
+
+jira_store_result_t jira_data_apply_patch(const char* json) {
+    ArenaJsonDocument doc(4096);
+    DeserializationError err = usb_sync_parse_payload(doc, json);
+
+    if (err) {
+        LOGW("Patch parse error: %s", err.c_str());
+        return parse_result(err);
+    }
+
+    uint16_t base = doc["base"] | 0;
+    if (!g_jira_state.synced || base != g_jira_state.version) {
+        LOGW("Patch base %u != version %u", base, g_jira_state.version);
+        return JIRA_STORE_MISALIGNED;
+    }
+
+    g_patch_selected_changed = false;
+    bool stored = true;
+    list_write_begin();
+
+    for (JsonObject op : doc["ops"].as<JsonArray>()) {
+        const char* key = op["key"] | "";
+        if (!key[0]) continue;
+
+        int idx = find_by_key(key);
+        const char* kind = op["op"] | "u";
+
+        if (kind[0] == 'd') {
+            if (idx < 0) continue;
+            uint16_t tail = g_jira_state.project_count - idx - 1;
+            memmove(&g_jira_state.projects[idx], &g_jira_state.projects[idx + 1],
+                    sizeof(jira_project_t) * tail);
+            memmove(&g_key_hash[idx], &g_key_hash[idx + 1], sizeof(uint32_t) * tail);
+            memmove(&g_recency[idx], &g_recency[idx + 1], sizeof(uint32_t) * tail);
+            g_jira_state.project_count--;
+            if (g_jira_state.total > 0) g_jira_state.total--;
+
+            // Keep the selection on the same issue; drop it if that issue went away
+            if (g_jira_state.selected_index == idx) {
+                g_jira_state.selected_index = -1;
+                g_patch_selected_changed = true;
+            } else if (g_jira_state.selected_index > idx) {
+                g_jira_state.selected_index--;
+            }
+            continue;
+        }
+
+        bool fresh = idx < 0;
+        uint16_t total_before = g_jira_state.total;
+        if (fresh) {
+            if (g_jira_state.project_count >= g_jira_state.capacity) {
+                stored = false;
+                break;
+            }
+            idx = g_jira_state.project_count++;
+            if (g_jira_state.total < g_jira_state.project_count) {
+                g_jira_state.total = g_jira_state.project_count;
+            }
+            jira_project_t* entry = &g_jira_state.projects[idx];
+            entry->key = entry->name = entry->proj = entry->status = entry->desc = "";
+        }
+
+        jira_project_t *entry = &g_jira_state.projects[idx];
+        bool changed = false;
+        stored = update_field(&entry->key, key, JIRA_FIELD_MAX, &changed);
+        if (stored && op.containsKey("name"))   stored = update_field(&entry->name, op["name"] | "", JIRA_FIELD_MAX, &changed);
+        if (stored && op.containsKey("proj"))   stored = update_field(&entry->proj, op["proj"] | "", JIRA_FIELD_MAX, &changed);
+        if (stored && op.containsKey("status")) stored = update_field(&entry->status, op["status"] | "", JIRA_FIELD_MAX, &changed);
+        if (stored && op.containsKey("desc"))   stored = update_field(&entry->desc, op["desc"] | "", JIRA_DESC_MAX, &changed);
+        if (!stored && fresh) {
+            // Don't leave a half-written record counted
+            g_jira_state.project_count--;
+            g_jira_state.total = total_before;
+            break;
+        }
+        g_key_hash[idx] = key_hash(entry->key);
+        if (changed) g_recency[idx] = RECENCY_BASE + ++g_recency_clock;
+        if (changed && idx == g_jira_state.selected_index) g_patch_selected_changed = true;
+        if (!stored) break;
+    }
+
+    if (!stored) {
+        // Partly applied - refuse patches until a full list rebuilds the store
+        LOGW("No room for patch (%u of %u records), resync needed",
+             g_jira_state.project_count, g_jira_state.capacity);
+        g_jira_state.synced = false;
+        build_indexes();
+        list_write_end();
+        return JIRA_STORE_FULL;
+    }
+
+    // Issues past the loaded window are counted, not patched
+    if (doc.containsKey("total")) {
+        g_jira_state.total = doc["total"] | g_jira_state.project_count;
+        if (g_jira_state.total < g_jira_state.project_count) {
+            g_jira_state.total = g_jira_state.project_count;
+        }
+    }
+
+    g_jira_state.version = doc["ver"] | (uint16_t)(base + 1);
+    build_indexes();
+    list_write_end();
+
+    LOGI("Patch -> v%u, %d of %d projects",
+                  g_jira_state.version, g_jira_state.project_count, g_jira_state.total);
+    return JIRA_STORE_OK;
+}
+
+char* jira_data_restore_text(uint32_t len) {
+    return len <= g_strings_size ? g_strings : NULL;
+}
+
+bool jira_data_restore(uint16_t count, uint16_t total, uint16_t version, bool synced,
+                       uint32_t len) {
+    if (count > g_jira_state.capacity || len > g_strings_size) return false;
+
+    list_write_begin();
+    clear_projects();
+    const char* p = g_strings;
+    const char* end = g_strings + len;
+    bool ok = true;
+    for (uint16_t i = 0; ok && i < count; i++) {
+        jira_project_t* entry = &g_jira_state.projects[i];
+        const char** fields[] = { &entry->key, &entry->name, &entry->proj, &entry->status, &entry->desc };
+        for (size_t f = 0; ok && f < sizeof(fields) / sizeof(fields[0]); f++) {
+            const char* nul = (const char*)memchr(p, '\0', end - p);
+            if (!nul) {
+                ok = false;
+                break;
+            }
+            *fields[f] = p;
+            p = nul + 1;
+        }
+        if (ok) {
+            g_key_hash[i] = key_hash(entry->key);
+            g_recency[i] = RECENCY_BASE - 1 - i;
+        }
+    }
+    if (ok) {
+        g_strings_used = len;
+        g_jira_state.project_count = count;
+        g_jira_state.total = total < count ? count : total;
+        g_jira_state.version = version;
+        g_jira_state.synced = synced;
+    }
+    build_indexes();
+    list_write_end();
+
+    if (!ok) {
+        LOGW("Saved issue text truncated");
+        return false;
+    }
+    data_bus_publish(DATA_TOPIC_JIRA);
+    return true;
 }
 
-uint8_t jira_data_get_count(void) {
+uint16_t jira_data_get_count(void) {
     return g_jira_state.project_count;
 }
 
-const jira_project_t* jira_data_get_project(uint8_t index) {
+uint16_t jira_data_get_total(void) {
+    return g_jira_state.total;
+}
+
+bool jira_data_has_more(void) {
+    return g_jira_state.project_count < g_jira_state.total &&
+           g_jira_state.project_count < g_jira_state.capacity && !g_store_full;
+}
+
+const jira_project_t* jira_data_get_project(uint16_t index) {
     if (index >= g_jira_state.project_count) return NULL;
     return &g_jira_state.projects[index];
 }
@@ -77,16 +706,443 @@ const jira_project_t* jira_data_get_selected(void) {
     return &g_jira_state.projects[g_jira_state.selected_index];
 }
 
-int8_t jira_data_get_selected_index(void) {
+// Bounded copy - a torn read may see a string without its terminator
+static void copy_text(char* dst, const char* src, size_t max) {
+    size_t n = 0;
+    while (n < max && src[n]) {
+        dst[n] = src[n];
+        n++;
+    }
+    dst[n] = '\0';
+}
+
+bool jira_data_read_selected(jira_issue_text_t* out) {
+    for (int attempt = 0; attempt < JIRA_READ_RETRIES; attempt++) {
+        uint32_t seq;
+        if (!list_read_begin(&seq)) continue;
+
+        int16_t sel = g_jira_state.selected_index;
+        bool found = sel >= 0 && sel < g_jira_state.project_count;
+        if (found) {
+            const jira_project_t* p = &g_jira_state.projects[sel];
+            copy_text(out->key, p->key, JIRA_FIELD_MAX);
+            copy_text(out->name, p->name, JIRA_FIELD_MAX);
+            copy_text(out->proj, p->proj, JIRA_FIELD_MAX);
+            copy_text(out->status, p->status, JIRA_FIELD_MAX);
+            copy_text(out->desc, p->desc, JIRA_DESC_MAX);
+        }
+        if (list_read_end(seq)) return found;
+    }
+    LOGW("Selected issue busy, read skipped");
+    return false;
+}
+
+// Views fall back to list order if their index could not be allocated
+static jira_view_t usable_view(jira_view_t view) {
+    if (view <= JIRA_VIEW_LIST || view >= JIRA_VIEW_COUNT || !g_views[view].order) {
+        return JIRA_VIEW_LIST;
+    }
+    return view;
+}
+
+// The view_* helpers read the indices unlocked - callers validate with
+// list_read_end(), and every value read stays inside the arrays even if
+// torn.
+static int16_t view_position(jira_view_t view, int16_t index) {
+    if (index < 0 || index >= g_jira_state.project_count) return -1;
+    return view == JIRA_VIEW_LIST ? index : g_views[view].rank[index];
+}
+
+static int16_t view_issue(jira_view_t view, int16_t pos) {
+    return view == JIRA_VIEW_LIST ? pos : g_views[view].order[pos];
+}
+
+// Group holding view position pos, by binary search over the group starts
+static uint16_t view_group_of(const view_index_t* vi, uint16_t groups, int16_t pos) {
+    uint16_t lo = 0, hi = groups - 1;
+    while (lo < hi) {
+        uint16_t mid = (lo + hi + 1) / 2;
+        if (vi->group_start[mid] <= pos) {
+            lo = mid;
+        } else {
+            hi = mid - 1;
+        }
+    }
+    return lo;
+}
+
+static int16_t view_step(jira_view_t view, int16_t index, int16_t steps) {
+    int16_t count = g_jira_state.project_count;
+    if (count == 0) return -1;
+
+    int16_t pos = view_position(view, index);
+    if (pos < 0) pos = steps > 0 ? -1 : count;
+    int32_t next = pos + steps;
+    if (next >= count) {
+        // Past the loaded window: hold on the last issue while its page loads
+        next = jira_data_has_more() ? count - 1 : 0;
+    } else if (next < 0) {
+        next = count - 1;
+    }
+    return view_issue(view, next);
+}
+
+static int16_t view_group_step(jira_view_t view, int16_t index, int16_t steps) {
+    const view_index_t* vi = &g_views[view];
+    uint16_t groups = view == JIRA_VIEW_LIST ? 0 : vi->group_count;
+    if (groups == 0) return view_step(view, index, steps);
+
+    int16_t pos = view_position(view, index);
+    int32_t group = pos < 0 ? (steps > 0 ? steps - 1 : groups + steps)
+                            : view_group_of(vi, groups, pos) + steps;
+    group %= groups;
+    if (group < 0) group += groups;
+    return vi->order[vi->group_start[group]];
+}
+
+int16_t jira_data_view_step(jira_view_t view, int16_t index, int16_t steps) {
+    view = usable_view(view);
+    for (int attempt = 0; attempt < JIRA_READ_RETRIES; attempt++) {
+        uint32_t seq;
+        if (!list_read_begin(&seq)) continue;
+        int16_t next = view_step(view, index, steps);
+        if (list_read_end(seq)) return next;
+    }
+    return index;
+}
+
+int16_t jira_data_view_group_step(jira_view_t view, int16_t index, int16_t steps) {
+    view = usable_view(view);
+    for (int attempt = 0; attempt < JIRA_READ_RETRIES; attempt++) {
+        uint32_t seq;
+        if (!list_read_begin(&seq)) continue;
+        int16_t next = view_group_step(view, index, steps);
+        if (list_read_end(seq)) return next;
+    }
+    return index;
+}
+
+int16_t jira_data_view_position(jira_view_t view, int16_t index) {
+    view = usable_view(view);
+    for (int attempt = 0; attempt < JIRA_READ_RETRIES; attempt++) {
+        uint32_t seq;
+        if (!list_read_begin(&seq)) continue;
+        int16_t pos = view_position(view, index);
+        if (list_read_end(seq)) return pos;
+    }
+    return -1;
+}
+
+bool jira_data_view_group(jira_view_t view, int16_t index, uint16_t* group, uint16_t* groups) {
+    view = usable_view(view);
+    if (view == JIRA_VIEW_LIST) return false;
+    const view_index_t* vi = &g_views[view];
+    for (int attempt = 0; attempt < JIRA_READ_RETRIES; attempt++) {
+        uint32_t seq;
+        if (!list_read_begin(&seq)) continue;
+        uint16_t count = vi->group_count;
+        int16_t pos = view_position(view, index);
+        bool found = count > 0 && pos >= 0;
+        if (found) {
+            *group = view_group_of(vi, count, pos);
+            *groups = count;
+        }
+        if (list_read_end(seq)) return found;
+    }
+    return false;
+}
+
+// True if text starts with the folded needle (case-insensitive)
+static bool starts_with_folded(const char* text, const char* needle, size_t len) {
+    size_t k = 0;
+    while (k < len && fold(text[k]) == (uint8_t)needle[k]) k++;
+    return k == len;
+}
+
+static bool contains_folded(const char* text, const char* needle, size_t len) {
+    for (; *text; text++) {
+        if (starts_with_folded(text, needle, len)) return true;
+    }
+    return false;
+}
+
+// How well issue index matches the folded query, lower is better; -1 = no match
+static int match_rank(uint16_t index, const char* q, size_t len) {
+    const jira_project_t* p = &g_jira_state.projects[index];
+    if (starts_with_folded(p->key, q, len)) return p->key[len] == '\0' ? 0 : 1;
+    if (contains_folded(p->key, q, len)) return 2;
+    if (len >= SEARCH_MIN_QUERY && contains_folded(p->name, q, len)) return 3;
+    return -1;
+}
+
+// Insert index into the best-first result list if it ranks high enough
+static void add_match(int16_t* out, int8_t* ranks, uint8_t* n, uint8_t max,
+                      int16_t index, int rank) {
+    uint8_t pos = *n;
+    while (pos > 0 && ranks[pos - 1] > rank) pos--;
+    if (pos >= max) return;
+    uint8_t last = *n < max ? *n : max - 1;
+    for (uint8_t k = last; k > pos; k--) {
+        out[k] = out[k - 1];
+        ranks[k] = ranks[k - 1];
+    }
+    out[pos] = index;
+    ranks[pos] = rank;
+    if (*n < max) (*n)++;
+}
+
+// Unlocked search - q is folded, upper the same query upper-cased for the
+// key table
+static uint8_t find_matches(const char* q, const char* upper, size_t len,
+                            int16_t* out, uint8_t max) {
+    int8_t ranks[JIRA_FIND_MAX];
+    uint8_t n = 0;
+    int16_t exact = -1;
+    uint16_t count = g_jira_state.project_count;
+
+    if (g_search_indexed) {
+        uint32_t h = key_hash(upper);
+        for (uint32_t slot = h & g_key_table_mask; g_key_table[slot];
+             slot = (slot + 1) & g_key_table_mask) {
+            uint16_t i = g_key_table[slot] - 1;
+            if (i < count && g_key_hash[i] == h && match_rank(i, q, len) == 0) {
+                exact = i;
+                add_match(out, ranks, &n, max, i, 0);
+                break;
+            }
+        }
+    }
+
+    if (!g_search_indexed || len < SEARCH_MIN_QUERY) {
+        // Short queries (key fragments like "44") and no index: scan
+        for (uint16_t i = 0; i < count; i++) {
+            int rank = i == exact ? -1 : match_rank(i, q, len);
+            if (rank >= 0) add_match(out, ranks, &n, max, i, rank);
+        }
+        return n;
+    }
+
+    // Every match contains all the query's trigrams - check the issues
+    // listed under the rarest one
+    uint32_t from = 0, to = UINT32_MAX;
+    for (size_t k = 0; k + SEARCH_MIN_QUERY <= len; k++) {
+        uint16_t b = trigram_bucket(q + k);
+        uint32_t begin = g_gram_start[b], end = g_gram_start[b + 1];
+        if (end - begin < to - from) {
+            from = begin;
+            to = end;
+        }
+    }
+    for (uint32_t k = from; k < to && k < g_postings_size; k++) {
+        uint16_t i = g_postings[k];
+        if (i >= count || i == exact) continue;
+        int rank = match_rank(i, q, len);
+        if (rank >= 0) add_match(out, ranks, &n, max, i, rank);
+    }
+    return n;
+}
+
+uint8_t jira_data_find(const char* query, int16_t* out, uint8_t max) {
+    char q[JIRA_FIELD_MAX + 1];
+    char upper[JIRA_FIELD_MAX + 1];
+    size_t len = 0;
+    for (; query[len] && len < JIRA_FIELD_MAX; len++) {
+        q[len] = fold(query[len]);
+        upper[len] = (query[len] >= 'a' && query[len] <= 'z') ? query[len] - ('a' - 'A') : query[len];
+    }
+    q[len] = upper[len] = '\0';
+    if (len == 0 || max == 0) return 0;
+    if (max > JIRA_FIND_MAX) max = JIRA_FIND_MAX;
+
+    for (int attempt = 0; attempt < JIRA_READ_RETRIES; attempt++) {
+        uint32_t seq;
+        if (!list_read_begin(&seq)) continue;
+        uint8_t n = find_matches(q, upper, len, out, max);
+        if (list_read_end(seq)) return n;
+    }
+    return 0;
+}
+
+int16_t jira_data_get_selected_index(void) {
     return g_jira_state.selected_index;
 }
 
+uint16_t jira_data_get_version(void) {
+    return g_jira_state.version;
+}
+
 bool jira_data_is_synced(void) {
     return g_jira_state.synced;
 }
 
-void jira_data_select(int8_t index) {
+void jira_data_select(int16_t index) {
     if (index == -1 || (index >= 0 && index < g_jira_state.project_count)) {
         g_jira_state.selected_index = index;
     }
 }
+
+void jira_data_prefetch(int16_t index) {
+    if (!jira_data_has_more() || !usb_sync_is_connected()) return;
+    if (index + JIRA_PAGE_PREFETCH < g_jira_state.project_count) return;
+
+    // One request in flight; ask again if the page never came
+    uint32_t now = millis();
+    if (g_page_requested_ms && now - g_page_requested_ms < JIRA_PAGE_RETRY_MS) return;
+    g_page_requested_ms = now ? now : 1;
+    usb_sync_send_jira_page(g_jira_state.project_count);
+}
+
+// JIRA_PROJECTS:<json> - issue list from Mac
+// Reply: JIRA_PROJECTS_OK, JIRA_PROJECTS_ERR:TOO_LARGE|INVALID with the old
+// list kept, or JIRA_PROJECTS_ERR:FULL:<loaded count> if only the first
+// issues fit
+static void handle_jira_projects_command(const char* payload) {
+    jira_store_result_t result = jira_data_set_projects(payload);
+    if (result == JIRA_STORE_FULL) {
+        usb_sync_printf("JIRA_PROJECTS_ERR:FULL:%u\n", g_jira_state.project_count);
+    } else if (result != JIRA_STORE_OK) {
+        usb_sync_printf("JIRA_PROJECTS_ERR:%s\n", store_result_name(result));
+        return;
+    } else {
+        usb_sync_printf("JIRA_PROJECTS_OK\n");
+    }
+    warm_start_note_update(DATA_TOPIC_JIRA, true);
+    data_bus_publish(DATA_TOPIC_JIRA);
+}
+
+// JIRA_PAGE_DATA:<json> - one page of the issue list from Mac
+// Reply: JIRA_PAGE_OK:<loaded count>, JIRA_PAGE_NAK:<loaded count> if
+// the page does not follow the loaded ones,
+// JIRA_PAGE_ERR:<loaded count>:TOO_LARGE|INVALID if it could not be parsed,
+// or JIRA_PAGE_ERR:<loaded count>:FULL if only part of it fit (no more
+// pages are asked for)
+static void handle_jira_page_data_command(const char* payload) {
+    jira_store_result_t result = jira_data_add_page(payload);
+    if (result == JIRA_STORE_MISALIGNED) {
+        usb_sync_printf("JIRA_PAGE_NAK:%u\n", g_jira_state.project_count);
+        return;
+    }
+    if (result == JIRA_STORE_FULL) {
+        usb_sync_printf("JIRA_PAGE_ERR:%u:FULL\n", g_jira_state.project_count);
+    } else if (result != JIRA_STORE_OK) {
+        usb_sync_printf("JIRA_PAGE_ERR:%u:%s\n", g_jira_state.project_count,
+                        store_result_name(result));
+        return;
+    } else {
+        usb_sync_printf("JIRA_PAGE_OK:%u\n", g_jira_state.project_count);
+    }
+    warm_start_note_update(DATA_TOPIC_JIRA, true);
+    data_bus_publish(DATA_TOPIC_JIRA);
+}
+
+// JIRA_FIND:<text> - search the loaded issues by key fragment or summary
+// Reply: JIRA_FOUND:<search us>:<key>,<key>,... best match first
+static void handle_jira_find_command(const char* payload) {
+    int16_t found[JIRA_FIND_MAX];
+    uint32_t start = micros();
+    uint8_t n = jira_data_find(payload, found, JIRA_FIND_MAX);
+    uint32_t elapsed = micros() - start;
+
+    usb_sync_tx_lock();
+    Serial.printf("JIRA_FOUND:%lu:", (unsigned long)elapsed);
+    for (uint8_t i = 0; i < n; i++) {
+        Serial.printf("%s%s", i ? "," : "", g_jira_state.projects[found[i]].key);
+    }
+    Serial.print("\n");
+    usb_sync_tx_unlock();
+}
+
+// One issue object from the stream - parsed on its own, written straight
+// into the list. The count is published when the stream ends.
+static void projects_stream_record(const char* json, size_t len) {
+    g_stream_records++;
+    if (g_stream_count >= g_jira_state.capacity) g_stream_full = true;
+    if (g_stream_full) return;
+
+    ArenaJsonDocument doc(1024);
+    DeserializationError err = deserializeJson(doc, json, len);
+    if (err) {
+        LOGW("Stream record parse error: %s", err.c_str());
+        return;
+    }
+    if (store_project(g_stream_count, doc.as<JsonObject>())) {
+        g_stream_count++;
+    } else {
+        g_stream_full = true;
+    }
+}
+
+static void projects_stream_begin(void) {
+    g_stream_count = 0;
+    g_stream_records = 0;
+    g_stream_full = false;
+    list_write_begin();
+    clear_projects();
+    list_write_end();
+    json_stream_begin(&g_projects_stream, 1, projects_stream_record);
+}
+
+static void projects_stream_feed(const char* data, size_t len) {
+    json_stream_feed(&g_projects_stream, data, len);
+}
+
+static void projects_stream_end(bool complete) {
+    list_write_begin();
+    g_jira_state.project_count = g_stream_count;
+    g_jira_state.total = g_stream_full ? g_stream_records : g_stream_count;
+    g_store_full = g_stream_full;
+    g_jira_state.version = 0;
+    build_indexes();
+    list_write_end();
+
+    if (!complete) {
+        // Keep what arrived, but NAK patches until a full list comes through
+        g_jira_state.synced = false;
+        LOGW("Project stream cut off after %d projects", g_stream_count);
+        warm_start_note_update(DATA_TOPIC_JIRA, true);
+        data_bus_publish(DATA_TOPIC_JIRA);
+        return;
+    }
+
+    g_jira_state.synced = true;
+    LOGI("Streamed %d projects (%u records, %u dropped), %u string bytes", g_stream_count,
+         g_projects_stream.records, g_projects_stream.dropped, (unsigned)g_strings_used);
+    if (g_stream_full) {
+        usb_sync_printf("JIRA_PROJECTS_ERR:FULL:%u\n", g_stream_count);
+    } else {
+        usb_sync_printf("JIRA_PROJECTS_OK\n");
+    }
+    warm_start_note_update(DATA_TOPIC_JIRA, true);
+    data_bus_publish(DATA_TOPIC_JIRA);
+}
+
+// JIRA_PATCH:<json> - issue list delta from Mac
+// Reply: JIRA_PATCH_OK:<ver>, or to request a full list JIRA_PATCH_NAK:<current
+// ver> (base mismatch) or JIRA_PATCH_ERR:FULL|TOO_LARGE|INVALID
+static void handle_jira_patch_command(const char* payload) {
+    uint16_t count_before = g_jira_state.project_count;
+    uint16_t total_before = g_jira_state.total;
+
+    jira_store_result_t result = jira_data_apply_patch(payload);
+    if (result == JIRA_STORE_MISALIGNED) {
+        usb_sync_printf("JIRA_PATCH_NAK:%u\n", g_jira_state.version);
+        return;
+    }
+    if (result != JIRA_STORE_OK) {
+        usb_sync_printf("JIRA_PATCH_ERR:%s\n", store_result_name(result));
+        if (result == JIRA_STORE_FULL) {
+            // Ops before the full one were applied - show and keep them
+            warm_start_note_update(DATA_TOPIC_JIRA, true);
+            data_bus_publish(DATA_TOPIC_JIRA);
+        }
+        return;
+    }
+    usb_sync_printf("JIRA_PATCH_OK:%u\n", g_jira_state.version);
+    warm_start_note_update(DATA_TOPIC_JIRA, true);
+
+    // Only redraw when something the Jira screens show has changed
+    if (g_jira_state.project_count != count_before ||
+        g_jira_state.total != total_before || g_patch_selected_changed) {
+        data_bus_publish(DATA_TOPIC_JIRA);
+    }
+}
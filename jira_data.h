@@ -8,29 +8,81 @@
 extern "C" {
 #endif
 
-// Limits
-#define JIRA_MAX_PROJECTS 20
-#define JIRA_KEY_LEN 16
-#define JIRA_NAME_LEN 48
-#define JIRA_PROJ_LEN 24
-#define JIRA_STATUS_LEN 16
-#define JIRA_DESC_LEN 128
-
-// Single issue entry
+// Limits - records and issue text live in PSRAM; without PSRAM the store
+// falls back to the small internal-RAM sizes
+#define JIRA_MAX_PROJECTS 1024
+#define JIRA_MAX_PROJECTS_INTERNAL 64
+// Issue text lives in one bump-allocated arena, reset by each full list
+#define JIRA_STRING_ARENA_SIZE (192 * 1024)
+#define JIRA_STRING_ARENA_INTERNAL 8192
+// Parse document for JIRA_PROJECTS / JIRA_PAGE_DATA, borrowed from the JSON
+// arena (JSON_ARENA_SIZE less room for a small nested document). HELLO
+// reports it so the companion sizes pages to fit.
+#define JIRA_DOC_SIZE 11264
+// Paging: how close to the end of the loaded window the knob gets before
+// the next page is requested
+#define JIRA_PAGE_PREFETCH 5
+#define JIRA_PAGE_RETRY_MS 5000
+// Longest stored field in bytes (longer text is cut)
+#define JIRA_FIELD_MAX 127
+#define JIRA_DESC_MAX 511
+// Attempts at a consistent read while the parser task rewrites the list
+#define JIRA_READ_RETRIES 8
+// Search: most matches jira_data_find() reports through JIRA_FIND, and
+// trigram hash buckets (a power of two)
+#define JIRA_FIND_MAX 8
+#define JIRA_SEARCH_BUCKET_BITS 11
+
+// Single issue entry - fields point into the string arena and are never NULL.
+// They stay valid until the next full list or JIRA_PATCH.
 typedef struct {
-    char key[JIRA_KEY_LEN];       // e.g. "DEMOCAI-44"
-    char name[JIRA_NAME_LEN];     // Issue summary
-    char proj[JIRA_PROJ_LEN];     // Project name e.g. "Democratized AI"
-    char status[JIRA_STATUS_LEN]; // Status e.g. "In Progress"
-    char desc[JIRA_DESC_LEN];     // Description (first ~3 lines)
+    const char* key;     // e.g. "DEMOCAI-44"
+    const char* name;    // Issue summary
+    const char* proj;    // Project name e.g. "Democratized AI"
+    const char* status;  // Status e.g. "In Progress"
+    const char* desc;    // Description (first ~3 lines)
 } jira_project_t;
 
+// Orders the knob can walk the loaded issues in. The sorted views are
+// indexed once per sync; STATUS and PROJECT are split into groups the
+// picker jumps between.
+typedef enum {
+    JIRA_VIEW_LIST = 0,   // Arrival order (companion sorts by last update)
+    JIRA_VIEW_RECENT,     // Most recently changed first, patches included
+    JIRA_VIEW_STATUS,     // In Progress, To Do / On Hold, then the rest
+    JIRA_VIEW_PROJECT,    // By project name
+    JIRA_VIEW_COUNT
+} jira_view_t;
+
+// Outcome of storing a full list, a page or a patch
+typedef enum {
+    JIRA_STORE_OK = 0,
+    JIRA_STORE_TOO_LARGE,    // Payload needs more than the parse document holds
+    JIRA_STORE_INVALID,      // Payload is not a readable list/page/patch
+    JIRA_STORE_MISALIGNED,   // Page does not follow the loaded issues, or patch base != version
+    JIRA_STORE_FULL,         // No record or string space left for everything sent
+} jira_store_result_t;
+
+// Copy of one issue's text, taken by jira_data_read_selected()
+typedef struct {
+    char key[JIRA_FIELD_MAX + 1];
+    char name[JIRA_FIELD_MAX + 1];
+    char proj[JIRA_FIELD_MAX + 1];
+    char status[JIRA_FIELD_MAX + 1];
+    char desc[JIRA_DESC_MAX + 1];
+} jira_issue_text_t;
+
 // Full Jira state (RAM-only, refreshed each USB connection)
+// The companion may hold more issues than are loaded: the first
+// project_count of total are here, later ones arrive page by page.
 typedef struct {
-    jira_project_t projects[JIRA_MAX_PROJECTS];
-    uint8_t project_count;
-    int8_t selected_index;   // -1 = none selected
-    bool synced;             // true if projects received from Mac
+    jira_project_t* projects;  // capacity records (PSRAM when present)
+    uint16_t capacity;
+    uint16_t project_count;    // Issues loaded
+    uint16_t total;            // Issues on the companion (>= project_count)
+    int16_t selected_index;    // -1 = none selected
+    bool synced;               // true if projects received from Mac
+    uint16_t version;          // List version: 0 after a full list, bumped by JIRA_PATCH
 } jira_state_t;
 
 // Initialize Jira data module
@@ -38,17 +90,74 @@ void jira_data_init(void);
 
 // Parse JSON project list from Mac companion
 // Expected format: [{"key":"PROJ","name":"Project Name"},...]
-void jira_data_set_projects(const char* json);
+// Nothing changes unless the whole list parses. FULL if only the first
+// issues fit: those are kept, and total stays at the list size.
+jira_store_result_t jira_data_set_projects(const char* json);
+
+// Store one page of the issue list
+// Expected format: {"offset":N,"total":T,"issues":[{"key":...},...]}
+// Offset 0 replaces the list; any other offset must equal the loaded count.
+// Nothing changes unless the page parses and lines up with what is loaded.
+// FULL if only part of the page fit: that part is kept and no further
+// pages are requested until a new list starts at offset 0.
+jira_store_result_t jira_data_add_page(const char* json);
+
+// Apply an incremental update keyed by issue key
+// Expected format: {"base":N,"ver":M,"total":T,"ops":[{"op":"u","key":"PROJ-1",...},{"op":"d","key":"PROJ-2"}]}
+// "u" upserts (fields as in jira_data_set_projects), "d" deletes; "total"
+// is optional.
+// MISALIGNED (nothing applied) if base does not match the current version.
+// FULL if an upsert found no free record or string space: ops stop there,
+// and patches are refused until a full list resyncs.
+jira_store_result_t jira_data_apply_patch(const char* json);
 
 // Getters
-uint8_t jira_data_get_count(void);
-const jira_project_t* jira_data_get_project(uint8_t index);
+uint16_t jira_data_get_count(void);   // Issues loaded
+uint16_t jira_data_get_total(void);   // Issues on the companion
+bool jira_data_has_more(void);        // Pages left to fetch
+uint16_t jira_data_get_version(void);
+const jira_project_t* jira_data_get_project(uint16_t index);
 const jira_project_t* jira_data_get_selected(void);
-int8_t jira_data_get_selected_index(void);
+// Consistent copy of the selected issue; false if none is selected.
+// Use this from the UI - the pointers above are rewritten by the parser task.
+bool jira_data_read_selected(jira_issue_text_t* out);
+int16_t jira_data_get_selected_index(void);
 bool jira_data_is_synced(void);
 
+// Warm start: the string arena as a buffer for len bytes of saved text
+// (key, name, proj, status, desc per issue, each NUL-terminated), or NULL
+// if it does not fit. jira_data_restore() then points count issues at it.
+char* jira_data_restore_text(uint32_t len);
+bool jira_data_restore(uint16_t count, uint16_t total, uint16_t version, bool synced,
+                       uint32_t len);
+
+// Views - issues are still addressed by list index. index -1 (none) steps
+// to the first or last issue of the view.
+// Issue steps positions from index in view order: wraps at the start, and
+// at the end unless more pages are coming (then it holds on the last one).
+// -1 if nothing is loaded.
+int16_t jira_data_view_step(jira_view_t view, int16_t index, int16_t steps);
+// First issue of the group steps groups from index's group (wrapping);
+// views without groups step issue by issue
+int16_t jira_data_view_group_step(jira_view_t view, int16_t index, int16_t steps);
+// Position of index in view order, -1 if it is not a loaded issue
+int16_t jira_data_view_position(jira_view_t view, int16_t index);
+// Group of index in view (0-based) and the view's group count; false for
+// views without groups
+bool jira_data_view_group(jira_view_t view, int16_t index, uint16_t* group, uint16_t* groups);
+
+// Find issues by key fragment or summary text, case-insensitive, best
+// match first: exact key, key prefix, key substring, summary substring.
+// Queries shorter than 3 characters only match keys. Fills out with up to
+// max list indices and returns how many.
+uint8_t jira_data_find(const char* query, int16_t* out, uint8_t max);
+
 // Select a project by index
-void jira_data_select(int8_t index);
+void jira_data_select(int16_t index);
+
+// Request the next page (JIRA_PAGE:<offset>) if index is within
+// JIRA_PAGE_PREFETCH of the end of the loaded window
+void jira_data_prefetch(int16_t index);
 
 #ifdef __cplusplus
 }
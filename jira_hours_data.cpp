@@ -1,37 +1,100 @@
+#define LOG_TAG "JiraHoursData"
 #include "jira_hours_data.h"
+#include "debug_log.h"
+#include "usb_sync.h"
+#include "data_bus.h"
+#include "warm_start.h"
+#include "snapshot.h"
 #include <Arduino.h>
 #include <ArduinoJson.h>
 #include <string.h>
 
-static jira_hours_state_t g_jira_hours_state;
+// Double-buffered so logged/target are always read as a pair
+static jira_hours_state_t g_jira_hours_buf[2];
+static snapshot_t g_jira_hours_snap = SNAPSHOT_INITIALIZER(&g_jira_hours_buf[0], &g_jira_hours_buf[1]);
+
+// Optimistic accounting: logged_min shown = last JIRA_HOURS value plus
+// worklogs confirmed since that it does not include yet
+static uint16_t g_confirmed_min = 0;
+static uint16_t g_pending_min = 0;
+static uint32_t g_pending_ms = 0;   // When the last worklog was added
+
+static void handle_jira_hours_command(const char* payload);
 
 void jira_hours_data_init(void) {
-    memset(&g_jira_hours_state, 0, sizeof(g_jira_hours_state));
-    g_jira_hours_state.synced = false;
-    Serial.println("JiraHoursData: Initialized");
+    snapshot_init(&g_jira_hours_snap, &g_jira_hours_buf[0], &g_jira_hours_buf[1],
+                  sizeof(jira_hours_state_t));
+    LOGI("Initialized");
+
+    usb_sync_register_command("JIRA_HOURS", handle_jira_hours_command);
 }
 
-void jira_hours_data_set(const char* json) {
+bool jira_hours_data_set(const char* json) {
     StaticJsonDocument<128> doc;
-    DeserializationError err = deserializeJson(doc, json);
+    DeserializationError err = usb_sync_parse_payload(doc, json);
 
     if (err) {
-        Serial.printf("JiraHoursData: JSON parse error: %s\n", err.c_str());
-        return;
+        LOGW("JSON parse error: %s", err.c_str());
+        return false;
     }
 
-    g_jira_hours_state.logged_min = doc["logged_min"] | 0;
-    g_jira_hours_state.target_min = doc["target_min"] | 0;
-    g_jira_hours_state.synced = true;
+    // Reconcile: keep the part of the pending minutes the new value can't
+    // contain yet. A drop means a new day or edited worklogs - start over.
+    uint16_t logged = doc["logged_min"] | 0;
+    uint32_t expected = (uint32_t)g_confirmed_min + g_pending_min;
+    if (g_pending_min && logged >= g_confirmed_min && logged < expected &&
+        millis() - g_pending_ms < JIRA_HOURS_SETTLE_MS) {
+        g_pending_min = expected - logged;
+    } else {
+        g_pending_min = 0;
+    }
+    g_confirmed_min = logged;
+
+    jira_hours_state_t* hs = (jira_hours_state_t*)snapshot_begin_write(&g_jira_hours_snap);
+    hs->logged_min = logged + g_pending_min;
+    hs->target_min = doc["target_min"] | 0;
+    hs->synced = true;
+    bool changed = snapshot_publish(&g_jira_hours_snap);
+
+    LOGI("%d min logged (%u pending), target %d min", hs->logged_min, g_pending_min, hs->target_min);
+    return changed;
+}
+
+bool jira_hours_data_add_logged(uint16_t minutes) {
+    if (minutes == 0) return false;
+    g_pending_min += minutes;
+    g_pending_ms = millis();
 
-    Serial.printf("JiraHoursData: %d min logged, target %d min\n",
-                  g_jira_hours_state.logged_min, g_jira_hours_state.target_min);
+    jira_hours_state_t* hs = (jira_hours_state_t*)snapshot_begin_write(&g_jira_hours_snap);
+    hs->logged_min = g_confirmed_min + g_pending_min;
+    LOGI("+%u min logged locally, %u pending", minutes, g_pending_min);
+    return snapshot_publish(&g_jira_hours_snap);
 }
 
 const jira_hours_state_t* jira_hours_data_get(void) {
-    return &g_jira_hours_state;
+    return (const jira_hours_state_t*)snapshot_live(&g_jira_hours_snap);
+}
+
+void jira_hours_data_snapshot(jira_hours_state_t* out) {
+    snapshot_read(&g_jira_hours_snap, out);
+}
+
+void jira_hours_data_restore(const jira_hours_state_t* saved) {
+    jira_hours_state_t* hs = (jira_hours_state_t*)snapshot_begin_write(&g_jira_hours_snap);
+    *hs = *saved;
+    g_confirmed_min = saved->logged_min;
+    g_pending_min = 0;
+    if (snapshot_publish(&g_jira_hours_snap)) data_bus_publish(DATA_TOPIC_JIRA_HOURS);
 }
 
 bool jira_hours_data_is_synced(void) {
-    return g_jira_hours_state.synced;
+    return jira_hours_data_get()->synced;
+}
+
+// JIRA_HOURS:<json> - daily hours from Mac
+static void handle_jira_hours_command(const char* payload) {
+    bool changed = jira_hours_data_set(payload);
+    usb_sync_printf("JIRA_HOURS_OK\n");
+    warm_start_note_update(DATA_TOPIC_JIRA_HOURS, changed);
+    if (changed) data_bus_publish(DATA_TOPIC_JIRA_HOURS);
 }
@@ -8,6 +8,10 @@
 extern "C" {
 #endif
 
+// A JIRA_HOURS fetched this soon after a local worklog may predate it;
+// later ones are trusted to include it
+#define JIRA_HOURS_SETTLE_MS (2 * 60 * 1000)
+
 typedef struct {
     uint16_t logged_min;   // Minutes logged to Jira today
     uint16_t target_min;   // 480 weekday, 0 weekend
@@ -15,8 +19,16 @@ typedef struct {
 } jira_hours_state_t;
 
 void jira_hours_data_init(void);
-void jira_hours_data_set(const char* json);
+bool jira_hours_data_set(const char* json);   // true if the state changed
+// Count minutes just confirmed logged (JIRA_LOG_OK) before the companion's
+// next JIRA_HOURS reports them; true if the state changed
+bool jira_hours_data_add_logged(uint16_t minutes);
+// Live buffer, valid until the next update - read single fields only
 const jira_hours_state_t* jira_hours_data_get(void);
+// Consistent copy of the whole state
+void jira_hours_data_snapshot(jira_hours_state_t* out);
+// Install a state saved by warm_start
+void jira_hours_data_restore(const jira_hours_state_t* saved);
 bool jira_hours_data_is_synced(void);
 
 #ifdef __cplusplus
@@ -0,0 +1,75 @@
+/*
+ * Shared JSON parse arena
+ *
+ * A LIFO bump allocator: json_arena_alloc() takes the recursive lock and
+ * hands out the next aligned block, json_arena_free() pops back to that
+ * block and gives the lock. Failed borrows still take the lock, since
+ * ArduinoJson releases every document - even an empty one - exactly once.
+ */
+
+#define LOG_TAG "JsonArena"
+#include "json_arena.h"
+#include "debug_log.h"
+#include <Arduino.h>
+#include <esp_heap_caps.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+
+static uint8_t* g_arena = NULL;
+static SemaphoreHandle_t g_arena_mux = NULL;
+static json_arena_stats_t g_arena_stats;
+
+void json_arena_init(void) {
+    if (g_arena) return;
+
+    memset(&g_arena_stats, 0, sizeof(g_arena_stats));
+    g_arena_mux = xSemaphoreCreateRecursiveMutex();
+    g_arena = (uint8_t*)heap_caps_malloc(JSON_ARENA_SIZE, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (!g_arena) {
+        g_arena = (uint8_t*)malloc(JSON_ARENA_SIZE);
+    }
+    if (!g_arena || !g_arena_mux) {
+        LOGE("No memory for %d byte arena", JSON_ARENA_SIZE);
+        return;
+    }
+    g_arena_stats.size = JSON_ARENA_SIZE;
+    LOGI("%d byte arena ready", JSON_ARENA_SIZE);
+}
+
+const json_arena_stats_t* json_arena_get_stats(void) {
+    return &g_arena_stats;
+}
+
+void* json_arena_alloc(size_t size) {
+    if (!g_arena_mux) return NULL;
+
+    if (xSemaphoreTakeRecursive(g_arena_mux, 0) != pdTRUE) {
+        g_arena_stats.waits++;
+        xSemaphoreTakeRecursive(g_arena_mux, portMAX_DELAY);
+    }
+
+    size = (size + 7) & ~(size_t)7;
+    if (!g_arena || size > g_arena_stats.size - g_arena_stats.in_use) {
+        g_arena_stats.failures++;
+        LOGW("Borrow of %u bytes failed (%u in use)",
+             (unsigned)size, (unsigned)g_arena_stats.in_use);
+        return NULL;
+    }
+
+    void* ptr = g_arena + g_arena_stats.in_use;
+    g_arena_stats.in_use += size;
+    g_arena_stats.borrows++;
+    if (g_arena_stats.in_use > g_arena_stats.high_water) {
+        g_arena_stats.high_water = g_arena_stats.in_use;
+    }
+    return ptr;
+}
+
+void json_arena_free(void* ptr) {
+    if (!g_arena_mux) return;
+
+    if (ptr) {
+        g_arena_stats.in_use = (uint8_t*)ptr - g_arena;
+    }
+    xSemaphoreGiveRecursive(g_arena_mux);
+}
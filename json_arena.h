@@ -0,0 +1,59 @@
+#ifndef JSON_ARENA_H
+#define JSON_ARENA_H
+
+/*
+ * Shared JSON parse arena
+ *
+ * One buffer (PSRAM when present) that the data modules borrow their
+ * JsonDocuments from instead of putting multi-KB StaticJsonDocuments on
+ * small task stacks. Documents are carved off the top of the arena and
+ * must be released in reverse order, which scoped documents do naturally.
+ * A recursive mutex lets one task nest documents while other tasks wait.
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Arena size - holds the largest document plus nested ones
+#define JSON_ARENA_SIZE 12288
+
+typedef struct {
+    uint32_t size;        // 0 until json_arena_init() succeeded
+    uint32_t in_use;
+    uint32_t high_water;  // Peak in_use since boot
+    uint32_t borrows;     // Documents handed out
+    uint32_t waits;       // Borrows that blocked on another task
+    uint32_t failures;    // Borrows that did not fit
+} json_arena_stats_t;
+
+// Allocate the arena - call first in setup(), before any module parses JSON
+void json_arena_init(void);
+
+const json_arena_stats_t* json_arena_get_stats(void);
+
+// Raw borrow/release - use ArenaJsonDocument instead
+void* json_arena_alloc(size_t size);
+void json_arena_free(void* ptr);
+
+#ifdef __cplusplus
+}
+
+#include <ArduinoJson.h>
+
+// ArduinoJson allocator over the arena; the arena lock is held from
+// allocate() to deallocate(), i.e. for the document's lifetime
+struct JsonArenaAllocator {
+    void* allocate(size_t size) { return json_arena_alloc(size); }
+    void deallocate(void* ptr) { json_arena_free(ptr); }
+    void* reallocate(void* ptr, size_t size) { return NULL; }  // No shrinkToFit()
+};
+
+// Drop-in for StaticJsonDocument<N>: ArenaJsonDocument doc(N);
+typedef BasicJsonDocument<JsonArenaAllocator> ArenaJsonDocument;
+#endif
+
+#endif // JSON_ARENA_H
@@ -0,0 +1,108 @@
+/*
+ * Incremental JSON record splitter
+ *
+ * A byte-at-a-time scanner that tracks string/escape state and container
+ * depth - just enough structure to cut records out of the stream. The
+ * records themselves are parsed by the caller with a record-sized document.
+ */
+
+#define LOG_TAG "JsonStream"
+#include "json_stream.h"
+#include "debug_log.h"
+#include <string.h>
+
+void json_stream_begin(json_stream_t* s, uint8_t record_depth, json_stream_record_fn on_record) {
+    memset(s, 0, offsetof(json_stream_t, record));
+    s->record_depth = record_depth;
+    s->on_record = on_record;
+    s->record[0] = '\0';
+    s->skeleton[0] = '\0';
+}
+
+// Append one byte to the record or skeleton, whichever is being collected
+static void stream_put(json_stream_t* s, char c) {
+    if (s->in_record) {
+        if (s->record_len < JSON_STREAM_RECORD_MAX - 1) {
+            s->record[s->record_len++] = c;
+        } else {
+            s->record_overflow = true;
+        }
+    } else if (s->skeleton_len < JSON_STREAM_SKELETON_MAX - 1) {
+        s->skeleton[s->skeleton_len++] = c;
+    } else {
+        s->skeleton_overflow = true;
+    }
+}
+
+static void stream_end_record(json_stream_t* s) {
+    s->in_record = false;
+    if (s->record_overflow) {
+        s->dropped++;
+        LOGW("Record over %d bytes dropped", JSON_STREAM_RECORD_MAX);
+        return;
+    }
+    s->record[s->record_len] = '\0';
+    s->records++;
+    s->on_record(s->record, s->record_len);
+}
+
+void json_stream_feed(json_stream_t* s, const char* data, size_t len) {
+    for (size_t i = 0; i < len && !s->done; i++) {
+        char c = data[i];
+
+        if (s->in_string) {
+            stream_put(s, c);
+            if (s->escape) {
+                s->escape = false;
+            } else if (c == '\\') {
+                s->escape = true;
+            } else if (c == '"') {
+                s->in_string = false;
+            }
+            continue;
+        }
+
+        switch (c) {
+        case ' ': case '\t': case '\r': case '\n':
+            break;
+        case '"':
+            s->in_string = true;
+            stream_put(s, c);
+            break;
+        case '{': case '[':
+            if (c == '{' && !s->in_record && s->depth == s->record_depth) {
+                s->in_record = true;
+                s->record_overflow = false;
+                s->record_len = 0;
+            }
+            s->depth++;
+            stream_put(s, c);
+            break;
+        case '}': case ']':
+            if (s->depth == 0) {
+                s->done = true;  // Unbalanced - stop rather than misparse
+                break;
+            }
+            s->depth--;
+            stream_put(s, c);
+            if (s->in_record && s->depth == s->record_depth) {
+                stream_end_record(s);
+            }
+            if (s->depth == 0) s->done = true;
+            break;
+        case ',':
+            // Separators between records would leave holes in the skeleton
+            if (s->in_record || s->depth != s->record_depth) stream_put(s, c);
+            break;
+        default:
+            stream_put(s, c);
+            break;
+        }
+    }
+}
+
+const char* json_stream_skeleton(json_stream_t* s) {
+    if (s->skeleton_overflow) return NULL;
+    s->skeleton[s->skeleton_len] = '\0';
+    return s->skeleton;
+}
@@ -0,0 +1,64 @@
+#ifndef JSON_STREAM_H
+#define JSON_STREAM_H
+
+/*
+ * Incremental JSON record splitter
+ *
+ * Fed a JSON document in arbitrary chunks, it hands every object found at
+ * record_depth (the number of containers enclosing it) to a callback as
+ * soon as its closing brace arrives:
+ *   record_depth 1:  [ {record}, {record} ]
+ *   record_depth 2:  { "events": [ {record}, {record} ], "next": 5 }
+ * Only one record is held at a time. Everything outside the records is kept
+ * as a small "skeleton" document, e.g. {"events":[],"next":5}, so scalar
+ * fields next to the list can still be parsed at the end.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Largest single record (JSON text); longer records are dropped
+#define JSON_STREAM_RECORD_MAX 768
+// Largest skeleton (document text outside the records)
+#define JSON_STREAM_SKELETON_MAX 128
+
+// Record callback - json is the NUL-terminated text of one object
+typedef void (*json_stream_record_fn)(const char* json, size_t len);
+
+typedef struct {
+    json_stream_record_fn on_record;
+    uint8_t record_depth;
+    uint8_t depth;
+    bool in_string;
+    bool escape;
+    bool in_record;
+    bool done;               // Top-level value closed - ignore the rest
+    bool record_overflow;    // Current record is too long
+    bool skeleton_overflow;
+    uint16_t record_len;
+    uint16_t skeleton_len;
+    uint16_t records;        // Records delivered
+    uint16_t dropped;        // Records too long to deliver
+    char record[JSON_STREAM_RECORD_MAX];
+    char skeleton[JSON_STREAM_SKELETON_MAX];
+} json_stream_t;
+
+// Reset s for a new document
+void json_stream_begin(json_stream_t* s, uint8_t record_depth, json_stream_record_fn on_record);
+
+// Feed the next len bytes of the document
+void json_stream_feed(json_stream_t* s, const char* data, size_t len);
+
+// NUL-terminated document text outside the records, or NULL if it overflowed
+const char* json_stream_skeleton(json_stream_t* s);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // JSON_STREAM_H
@@ -10,6 +10,8 @@
 #include "calendar_data.h"
 #include "jira_hours_data.h"
 #include "usb_sync.h"
+#include "data_bus.h"
+#include "warm_start.h"
 #include "home_bg.h"
 #include "focusknob_icons.h"
 #include "bts_quiz_data.h"
@@ -356,8 +358,17 @@ static lv_obj_t *jira_picker_name_label = NULL;
 static lv_obj_t *jira_picker_status_label = NULL;
 static lv_obj_t *jira_picker_pos_label = NULL;
 static lv_obj_t *jira_picker_hint_label = NULL;
+static lv_obj_t *jira_picker_view_btn = NULL;
+static lv_obj_t *jira_picker_view_label = NULL;
 static bool jira_picker_open = false;
 
+// Order the knob walks issues in - picked in the picker, grouped views
+// jump a group per detent there
+static jira_view_t jira_view = JIRA_VIEW_LIST;
+static const char *const jira_view_names[JIRA_VIEW_COUNT] = {
+    "List", "Recent", "By status", "By project"
+};
+
 // Jira timer screen UI elements
 static lv_obj_t *jira_timer_screen = NULL;
 static lv_obj_t *jira_timer_arc = NULL;
@@ -606,9 +617,43 @@ static void apply_btn_press_style(lv_obj_t *btn) {
     lv_obj_set_style_transition(btn, &trans_btn, 0);
 }
 
+// Consistent copies of the data stores for one redraw. The parser task
+// publishes updates while LVGL draws, so multi-field reads go through these.
+// Static rather than on the small LVGL stack; callers hold lvgl_mux.
+static const weather_state_t *weather_snapshot(void) {
+    static weather_state_t snap;
+    weather_data_snapshot(&snap);
+    return &snap;
+}
+
+static const calendar_state_t *calendar_snapshot(void) {
+    static calendar_state_t snap;
+    calendar_data_snapshot(&snap);
+    return &snap;
+}
+
+static const jira_hours_state_t *jira_hours_snapshot(void) {
+    static jira_hours_state_t snap;
+    jira_hours_data_snapshot(&snap);
+    return &snap;
+}
+
+// NULL if no issue is selected
+static const jira_issue_text_t *jira_selected_snapshot(void) {
+    static jira_issue_text_t snap;
+    return jira_data_read_selected(&snap) ? &snap : NULL;
+}
+
+// Dim widgets showing data restored from flash until the companion
+// confirms it (warm start)
+static void apply_stale_style(lv_obj_t *obj, uint32_t topic) {
+    if (obj) lv_obj_set_style_opa(obj, warm_start_is_stale(topic) ? LV_OPA_50 : LV_OPA_COVER, 0);
+}
+
 // Forward declarations for home screen
 static void create_home_ui(void);
 static void update_clock(lv_timer_t *timer);
+static void update_home_calendar(void);
 static void show_home_screen(void);
 static void show_timer_screen(void);
 
@@ -653,6 +698,7 @@ static void show_jira_picker(void);
 static void hide_jira_picker(void);
 static void update_jira_picker_display(void);
 static void jira_picker_overlay_cb(lv_event_t *e);
+static void jira_picker_view_cb(lv_event_t *e);
 
 // Forward declarations for Jira timer
 static void create_jira_timer_ui(void);
@@ -1438,6 +1484,12 @@ static void update_clock(lv_timer_t *timer)
     time(&now);
     localtime_r(&now, &timeinfo);
 
+    // Every label below changes at most once a minute - skip the redraw
+    static int shown_min = -1, shown_yday = -1;
+    if (timeinfo.tm_min == shown_min && timeinfo.tm_yday == shown_yday) return;
+    shown_min = timeinfo.tm_min;
+    shown_yday = timeinfo.tm_yday;
+
     // Update time (12-hour format with AM/PM)
     static char time_buf[16];
     strftime(time_buf, sizeof(time_buf), "%I:%M %p", &timeinfo);
@@ -1462,21 +1514,36 @@ static void update_clock(lv_timer_t *timer)
     if (home_day_label) lv_label_set_text(home_day_label, day_buf);
     if (home_day_shadow) lv_label_set_text(home_day_shadow, day_buf);
 
-    // Update home screen weather display (icon + temp + condition)
-    if (weather_data_is_synced() && home_weather_icon && home_weather_temp) {
-        const weather_current_t* w = weather_data_get_current();
-        if (w) {
+    // Meeting countdown runs off the local clock
+    update_home_calendar();
+    if (current_screen == SCREEN_CALENDAR) update_calendar_display();
+}
+
+// Home screen weather (icon + temp + condition)
+static void update_home_weather(void)
+{
+    if (home_weather_icon && home_weather_temp) {
+        const weather_state_t* ws = weather_snapshot();
+        const weather_current_t* w = &ws->current;
+        if (ws->synced) {
             lv_label_set_text(home_weather_icon, weather_icon_for_condition(w->condition_id));
             static char wbuf[32];
             snprintf(wbuf, sizeof(wbuf), "%d\xC2\xB0  %s", w->temp, w->condition);
             lv_label_set_text(home_weather_temp, wbuf);
+            apply_stale_style(home_weather_icon, DATA_TOPIC_WEATHER);
+            apply_stale_style(home_weather_temp, DATA_TOPIC_WEATHER);
         }
     }
+}
 
-    // Update home screen calendar display
-    if (calendar_data_is_synced() && home_calendar_label) {
-        int16_t mins = calendar_data_get_next_meeting_min();
-        const calendar_event_t* next = calendar_data_get_event(0);
+// Home screen next meeting
+static void update_home_calendar(void)
+{
+    const calendar_state_t* cs = calendar_snapshot();
+    if (cs->synced && home_calendar_label) {
+        const calendar_event_t* next;
+        int16_t mins = calendar_data_next_meeting(cs, (uint32_t)time(NULL), &next);
+        apply_stale_style(home_calendar_label, DATA_TOPIC_CALENDAR);
         if (mins == -1 && next) {
             // Meeting in progress
             static char cal_buf[48];
@@ -1494,10 +1561,14 @@ static void update_clock(lv_timer_t *timer)
             lv_label_set_text(home_calendar_label, "");
         }
     }
+}
 
-    // Update Jira daily hours display
-    if (jira_hours_data_is_synced() && home_jira_hours_label) {
-        const jira_hours_state_t* h = jira_hours_data_get();
+// Home screen Jira daily hours
+static void update_home_jira_hours(void)
+{
+    const jira_hours_state_t* h = jira_hours_snapshot();
+    if (h->synced && home_jira_hours_label) {
+        apply_stale_style(home_jira_hours_label, DATA_TOPIC_JIRA_HOURS);
         if (h->target_min > 0) {
             // Weekday — show hours logged vs target
             float logged = h->logged_min / 60.0f;
@@ -1521,6 +1592,19 @@ static void update_clock(lv_timer_t *timer)
     }
 }
 
+// Data bus subscriber: redraw only the home widgets whose data changed
+static void home_data_changed(uint32_t topics)
+{
+    if (topics & DATA_TOPIC_WEATHER) update_home_weather();
+    if (topics & DATA_TOPIC_CALENDAR) update_home_calendar();
+    if (topics & DATA_TOPIC_JIRA_HOURS) update_home_jira_hours();
+}
+
+static void data_bus_timer_cb(lv_timer_t *timer)
+{
+    data_bus_dispatch();
+}
+
 static void show_home_screen(void)
 {
     hide_all_screens();
@@ -2039,8 +2123,8 @@ static void update_jira_display(void)
         jira_loading_timer = NULL;
     }
 
-    int8_t sel_idx = jira_data_get_selected_index();
-    uint8_t count = jira_data_get_count();
+    int16_t sel_idx = jira_data_get_selected_index();
+    uint16_t count = jira_data_get_total();
 
     if (sel_idx < 0) {
         // === DASHBOARD MODE === show issue count + hint to turn right
@@ -2049,6 +2133,7 @@ static void update_jira_display(void)
         snprintf(count_buf, sizeof(count_buf), "%d", count);
         lv_label_set_text(jira_dash_count_label, count_buf);
         lv_obj_clear_flag(jira_dash_count_label, LV_OBJ_FLAG_HIDDEN);
+        apply_stale_style(jira_dash_count_label, DATA_TOPIC_JIRA);
 
         // Update title to show "issues" context
         static char dash_title[32];
@@ -2074,7 +2159,7 @@ static void update_jira_display(void)
         // Restore title
         lv_label_set_text(jira_title_label, LV_SYMBOL_EDIT " Jira");
 
-        const jira_project_t *sel = jira_data_get_selected();
+        const jira_issue_text_t *sel = jira_selected_snapshot();
         if (sel) {
             // Issue key (tappable to open in browser)
             lv_label_set_text(jira_selected_label, sel->key);
@@ -2139,7 +2224,7 @@ static void jira_start_btn_cb(lv_event_t *e)
 
 static void jira_log_btn_cb(lv_event_t *e)
 {
-    const jira_project_t *sel = jira_data_get_selected();
+    const jira_issue_text_t *sel = jira_selected_snapshot();
     if (sel) {
         // Send manual log request to Mac companion (always send, even if connection state stale)
         usb_sync_send_jira_log_time(sel->key);
@@ -2156,7 +2241,7 @@ static void jira_log_btn_cb(lv_event_t *e)
 
 static void jira_open_issue_cb(lv_event_t *e)
 {
-    const jira_project_t *sel = jira_data_get_selected();
+    const jira_issue_text_t *sel = jira_selected_snapshot();
     if (sel) {
         haptic_click();
         show_jira_detail();
@@ -2295,7 +2380,7 @@ static void create_jira_detail_ui(void)
 
 static void update_jira_detail_display(void)
 {
-    const jira_project_t *sel = jira_data_get_selected();
+    const jira_issue_text_t *sel = jira_selected_snapshot();
     if (!sel) return;
 
     lv_label_set_text(jira_detail_key_label, sel->key);
@@ -2349,7 +2434,7 @@ static void jira_detail_close_cb(lv_event_t *e)
 
 static void jira_detail_open_browser_cb(lv_event_t *e)
 {
-    const jira_project_t *sel = jira_data_get_selected();
+    const jira_issue_text_t *sel = jira_selected_snapshot();
     if (sel) {
         haptic_click();
         usb_sync_send_jira_open(sel->key);
@@ -2428,14 +2513,49 @@ static void create_jira_picker_ui(void)
     lv_obj_set_style_text_color(jira_picker_hint_label, COLOR_TEXT_DIM, 0);
     lv_obj_align(jira_picker_hint_label, LV_ALIGN_CENTER, 0, 85);
     lv_label_set_text(jira_picker_hint_label, "Turn knob | Tap to select");
+
+    // View toggle at top - tap to cycle list / recent / status / project
+    jira_picker_view_btn = lv_btn_create(jira_picker_overlay);
+    lv_obj_set_size(jira_picker_view_btn, 150, 30);
+    lv_obj_align(jira_picker_view_btn, LV_ALIGN_CENTER, 0, -100);
+    lv_obj_set_style_bg_color(jira_picker_view_btn, COLOR_ARC_BG, 0);
+    lv_obj_set_style_radius(jira_picker_view_btn, 15, 0);
+    lv_obj_set_style_shadow_width(jira_picker_view_btn, 0, 0);
+    lv_obj_add_event_cb(jira_picker_view_btn, jira_picker_view_cb, LV_EVENT_CLICKED, NULL);
+
+    jira_picker_view_label = lv_label_create(jira_picker_view_btn);
+    lv_obj_set_style_text_font(jira_picker_view_label, &lv_font_montserrat_12, 0);
+    lv_obj_set_style_text_color(jira_picker_view_label, COLOR_TEXT, 0);
+    lv_obj_center(jira_picker_view_label);
+    lv_label_set_text(jira_picker_view_label, "");
 }
 
 static void update_jira_picker_display(void)
 {
-    int8_t idx = jira_data_get_selected_index();
-    const jira_project_t *issue = jira_data_get_selected();
+    int16_t idx = jira_data_get_selected_index();
+    const jira_issue_text_t *issue = jira_selected_snapshot();
+    uint16_t group, groups;
+
+    static char view_buf[24];
+    snprintf(view_buf, sizeof(view_buf), LV_SYMBOL_LIST " %s", jira_view_names[jira_view]);
+    lv_label_set_text(jira_picker_view_label, view_buf);
+
+    if (issue && jira_data_view_group(jira_view, idx, &group, &groups)) {
+        // Grouped view - the knob lands on the first issue of each group
+        const char *name = jira_view == JIRA_VIEW_STATUS ? issue->status : issue->proj;
+        lv_label_set_text(jira_picker_key_label, name[0] ? name : "(none)");
+        lv_obj_set_style_text_color(jira_picker_key_label, get_accent_color(), 0);
 
-    if (issue) {
+        static char first_buf[JIRA_FIELD_MAX + 16];
+        snprintf(first_buf, sizeof(first_buf), "%s  %s", issue->key, issue->name);
+        lv_label_set_text(jira_picker_proj_label, "");
+        lv_label_set_text(jira_picker_name_label, first_buf);
+        lv_label_set_text(jira_picker_status_label, "");
+
+        static char group_buf[24];
+        snprintf(group_buf, sizeof(group_buf), "group %u / %u", group + 1, groups);
+        lv_label_set_text(jira_picker_pos_label, group_buf);
+    } else if (issue) {
         lv_label_set_text(jira_picker_key_label, issue->key);
         lv_label_set_text(jira_picker_proj_label, issue->proj);
         lv_label_set_text(jira_picker_name_label, issue->name);
@@ -2452,7 +2572,8 @@ static void update_jira_picker_display(void)
         }
 
         static char pos_buf[16];
-        snprintf(pos_buf, sizeof(pos_buf), "%d / %d", idx + 1, jira_data_get_count());
+        snprintf(pos_buf, sizeof(pos_buf), "%d / %d",
+                 jira_data_view_position(jira_view, idx) + 1, jira_data_get_total());
         lv_label_set_text(jira_picker_pos_label, pos_buf);
     } else {
         lv_label_set_text(jira_picker_key_label, "---");
@@ -2488,6 +2609,16 @@ static void jira_picker_overlay_cb(lv_event_t *e)
     update_jira_display();
 }
 
+static void jira_picker_view_cb(lv_event_t *e)
+{
+    // Next view; grouped views start on the first issue of the current group
+    haptic_click();
+    jira_view = (jira_view_t)((jira_view + 1) % JIRA_VIEW_COUNT);
+    int16_t idx = jira_data_get_selected_index();
+    if (idx >= 0) jira_data_select(jira_data_view_group_step(jira_view, idx, 0));
+    update_jira_picker_display();
+}
+
 // ============================================================
 // Jira Timer Screen
 // ============================================================
@@ -2583,7 +2714,7 @@ static void create_jira_timer_ui(void)
 static void update_jira_timer_display(void)
 {
     // Project key
-    const jira_project_t *sel = jira_data_get_selected();
+    const jira_issue_text_t *sel = jira_selected_snapshot();
     if (sel) {
         lv_label_set_text(jira_timer_project_label, sel->key);
     }
@@ -2672,7 +2803,7 @@ static void jira_timer_countdown_cb(lv_timer_t *timer)
         // Log to the general time log
         time_log_add_session(SESSION_WORK, jira_set_minutes);
         // Send completion to Mac companion
-        const jira_project_t *sel = jira_data_get_selected();
+        const jira_issue_text_t *sel = jira_selected_snapshot();
         if (sel) {
             usb_sync_send_jira_timer_done(sel->key, jira_set_minutes);
         }
@@ -2813,22 +2944,19 @@ void jira_knob_left(void)
             // Scroll up in detail overlay
             lv_obj_scroll_by(jira_detail_content, 0, 30, LV_ANIM_ON);
         } else if (jira_picker_open) {
-            // Cycle through projects in picker overlay
-            int8_t idx = jira_data_get_selected_index();
-            idx--;
-            if (idx < 0) idx = jira_data_get_count() - 1;
-            jira_data_select(idx);
+            // Cycle through issues (or groups) in picker overlay
+            int16_t idx = jira_data_get_selected_index();
+            jira_data_select(jira_data_view_group_step(jira_view, idx, -1));
             haptic_click();
             update_jira_picker_display();
         } else if (current_screen == SCREEN_JIRA && jira_data_get_count() > 0) {
-            // Navigate issues: left from first issue → back to dashboard
-            int8_t idx = jira_data_get_selected_index();
-            if (idx <= 0) {
+            // Navigate issues in view order: left from first issue → back to dashboard
+            int16_t idx = jira_data_get_selected_index();
+            if (jira_data_view_position(jira_view, idx) <= 0) {
                 // Go back to dashboard
                 jira_data_select(-1);
             } else {
-                idx--;
-                jira_data_select(idx);
+                jira_data_select(jira_data_view_step(jira_view, idx, -1));
             }
             haptic_click();
             update_jira_display();
@@ -2849,23 +2977,17 @@ void jira_knob_right(void)
             // Scroll down in detail overlay
             lv_obj_scroll_by(jira_detail_content, 0, -30, LV_ANIM_ON);
         } else if (jira_picker_open) {
-            int8_t idx = jira_data_get_selected_index();
-            idx++;
-            if (idx >= jira_data_get_count()) idx = 0;
+            int16_t idx = jira_data_view_group_step(jira_view, jira_data_get_selected_index(), 1);
             jira_data_select(idx);
+            jira_data_prefetch(jira_data_view_position(jira_view, idx));
             haptic_click();
             update_jira_picker_display();
         } else if (current_screen == SCREEN_JIRA && jira_data_get_count() > 0) {
-            // Navigate issues: right from dashboard → first issue, right from last → wrap to first
-            int8_t idx = jira_data_get_selected_index();
-            if (idx < 0) {
-                // Dashboard → first issue
-                jira_data_select(0);
-            } else {
-                idx++;
-                if (idx >= jira_data_get_count()) idx = 0;
-                jira_data_select(idx);
-            }
+            // Navigate issues in view order: right from dashboard → first issue,
+            // right from last → wrap to first (or hold while the next page loads)
+            int16_t idx = jira_data_view_step(jira_view, jira_data_get_selected_index(), 1);
+            jira_data_select(idx);
+            jira_data_prefetch(jira_data_view_position(jira_view, idx));
             haptic_click();
             update_jira_display();
         } else if (current_screen == SCREEN_JIRA_TIMER && jira_timer_state == TIMER_STATE_READY) {
@@ -2937,13 +3059,10 @@ bool is_jira_picker_open(void)
     return jira_picker_open;
 }
 
-void jira_update_projects_ui(void)
+// Data bus subscriber: issue list changed — always refresh Jira screen
+static void jira_screen_data_changed(uint32_t topics)
 {
-    // Called from usb_sync when projects arrive — always refresh Jira screen
-    if (xSemaphoreTake(lvgl_mux, pdMS_TO_TICKS(100)) == pdTRUE) {
-        update_jira_display();
-        xSemaphoreGive(lvgl_mux);
-    }
+    update_jira_display();
 }
 
 void jira_update_log_status(bool success, const char* message)
@@ -3095,7 +3214,14 @@ static void create_weather_ui(void) {
 static void update_weather_display(void) {
     if (!weather_screen) return;
 
-    if (!weather_data_is_synced()) {
+    // Widgets keep their text while hidden - redraw only after new data
+    static uint32_t drawn_gen = UINT32_MAX;
+    uint32_t gen = data_bus_generation(DATA_TOPIC_WEATHER);
+    if (gen == drawn_gen) return;
+    drawn_gen = gen;
+
+    const weather_state_t* ws = weather_snapshot();
+    if (!ws->synced) {
         // Show loading, hide data
         if (weather_loading_label) lv_obj_clear_flag(weather_loading_label, LV_OBJ_FLAG_HIDDEN);
         return;
@@ -3104,8 +3230,10 @@ static void update_weather_display(void) {
     // Hide loading
     if (weather_loading_label) lv_obj_add_flag(weather_loading_label, LV_OBJ_FLAG_HIDDEN);
 
-    const weather_current_t* w = weather_data_get_current();
-    if (!w) return;
+    const weather_current_t* w = &ws->current;
+    apply_stale_style(weather_temp_label, DATA_TOPIC_WEATHER);
+    apply_stale_style(weather_icon_label, DATA_TOPIC_WEATHER);
+    apply_stale_style(weather_condition_label, DATA_TOPIC_WEATHER);
 
     // Temperature
     static char temp_buf[16];
@@ -3131,15 +3259,13 @@ static void update_weather_display(void) {
     lv_label_set_text(weather_wind_label, wind_buf);
 
     // Forecast entries (show up to 4)
-    uint8_t count = weather_data_get_forecast_count();
+    uint8_t count = ws->forecast_count;
     for (int i = 0; i < 4; i++) {
         if (i < count && weather_forecast_labels[i]) {
-            const weather_forecast_t* f = weather_data_get_forecast(i);
-            if (f) {
-                static char fbuf[4][24];
-                snprintf(fbuf[i], sizeof(fbuf[i]), "%s\n%d\xC2\xB0", f->hour_str, f->temp);
-                lv_label_set_text(weather_forecast_labels[i], fbuf[i]);
-            }
+            const weather_forecast_t* f = &ws->forecast[i];
+            static char fbuf[4][24];
+            snprintf(fbuf[i], sizeof(fbuf[i]), "%s\n%d\xC2\xB0", f->hour_str, f->temp);
+            lv_label_set_text(weather_forecast_labels[i], fbuf[i]);
         } else if (weather_forecast_labels[i]) {
             lv_label_set_text(weather_forecast_labels[i], "");
         }
@@ -3169,23 +3295,10 @@ bool is_weather_screen_active(void) {
     return current_screen == SCREEN_WEATHER;
 }
 
-void weather_update_ui(void) {
-    if (xSemaphoreTake(lvgl_mux, pdMS_TO_TICKS(100)) == pdTRUE) {
-        // Update weather app screen if visible
-        if (current_screen == SCREEN_WEATHER) {
-            update_weather_display();
-        }
-        // Update home screen weather (icon + temp + condition)
-        if (weather_data_is_synced() && home_weather_icon && home_weather_temp) {
-            const weather_current_t* w = weather_data_get_current();
-            if (w) {
-                lv_label_set_text(home_weather_icon, weather_icon_for_condition(w->condition_id));
-                static char wt_buf2[32];
-                snprintf(wt_buf2, sizeof(wt_buf2), "%d\xC2\xB0  %s", w->temp, w->condition);
-                lv_label_set_text(home_weather_temp, wt_buf2);
-            }
-        }
-        xSemaphoreGive(lvgl_mux);
+// Data bus subscriber
+static void weather_screen_data_changed(uint32_t topics) {
+    if (current_screen == SCREEN_WEATHER) {
+        update_weather_display();
     }
 }
 
@@ -3197,10 +3310,10 @@ static void calendar_back_cb(lv_event_t *e) {
 
 static void calendar_log_cb(lv_event_t *e) {
     // Find first non-all-day event to log
-    uint8_t count = calendar_data_get_count();
-    for (uint8_t i = 0; i < count; i++) {
-        const calendar_event_t* ev = calendar_data_get_event(i);
-        if (ev && !ev->is_all_day) {
+    const calendar_state_t* cs = calendar_snapshot();
+    for (uint8_t i = 0; i < cs->event_count; i++) {
+        const calendar_event_t* ev = &cs->events[i];
+        if (!ev->is_all_day) {
             usb_sync_send_jira_log_meeting(ev->title, ev->duration_min);
             break;
         }
@@ -3286,31 +3399,47 @@ static void create_calendar_ui(void) {
 static void update_calendar_display(void) {
     if (!calendar_screen) return;
 
-    if (!calendar_data_is_synced()) {
+    // Widgets keep their text while hidden - redraw after new data, and
+    // once a minute so meetings that have ended drop off
+    static uint32_t drawn_gen = UINT32_MAX, drawn_min = UINT32_MAX;
+    uint32_t gen = data_bus_generation(DATA_TOPIC_CALENDAR);
+    uint32_t now = (uint32_t)time(NULL);
+    if (gen == drawn_gen && now / 60 == drawn_min) return;
+    drawn_gen = gen;
+    drawn_min = now / 60;
+
+    const calendar_state_t* cs = calendar_snapshot();
+    if (!cs->synced) {
         if (calendar_loading_label) lv_obj_clear_flag(calendar_loading_label, LV_OBJ_FLAG_HIDDEN);
         return;
     }
 
     if (calendar_loading_label) lv_obj_add_flag(calendar_loading_label, LV_OBJ_FLAG_HIDDEN);
 
-    uint8_t count = calendar_data_get_count();
+    uint8_t count = 0;
     static char evbuf[7][48];
 
-    for (int i = 0; i < 7; i++) {
-        if (i < count && calendar_event_labels[i]) {
-            const calendar_event_t* ev = calendar_data_get_event(i);
-            if (ev) {
-                if (ev->is_all_day) {
-                    snprintf(evbuf[i], sizeof(evbuf[i]), "All day  %s", ev->title);
-                } else {
-                    snprintf(evbuf[i], sizeof(evbuf[i]), "%s  %s (%dm)",
-                             ev->start_str, ev->title, ev->duration_min);
-                }
-                lv_label_set_text(calendar_event_labels[i], evbuf[i]);
-            }
-        } else if (calendar_event_labels[i]) {
-            lv_label_set_text(calendar_event_labels[i], "");
+    for (uint8_t i = 0; i < cs->event_count && count < 7; i++) {
+        const calendar_event_t* ev = &cs->events[i];
+        if (calendar_data_event_ended(ev, now)) continue;
+
+        if (ev->is_all_day) {
+            snprintf(evbuf[count], sizeof(evbuf[count]), "All day  %s", ev->title);
+        } else {
+            snprintf(evbuf[count], sizeof(evbuf[count]), "%s  %s (%dm)",
+                     ev->start_str, ev->title, ev->duration_min);
+        }
+        if (calendar_event_labels[count]) {
+            lv_obj_set_style_text_color(calendar_event_labels[count], COLOR_TEXT, 0);
+            lv_label_set_text(calendar_event_labels[count], evbuf[count]);
         }
+        count++;
+    }
+    for (int i = count; i < 7; i++) {
+        if (calendar_event_labels[i]) lv_label_set_text(calendar_event_labels[i], "");
+    }
+    for (int i = 0; i < 7; i++) {
+        apply_stale_style(calendar_event_labels[i], DATA_TOPIC_CALENDAR);
     }
 
     if (count == 0) {
@@ -3336,60 +3465,10 @@ bool is_calendar_screen_active(void) {
     return current_screen == SCREEN_CALENDAR;
 }
 
-void calendar_update_ui(void) {
-    if (xSemaphoreTake(lvgl_mux, pdMS_TO_TICKS(100)) == pdTRUE) {
-        // Update calendar app screen if visible
-        if (current_screen == SCREEN_CALENDAR) {
-            update_calendar_display();
-        }
-        // Update home screen calendar label
-        if (calendar_data_is_synced() && home_calendar_label) {
-            int16_t mins = calendar_data_get_next_meeting_min();
-            const calendar_event_t* next = calendar_data_get_event(0);
-            if (mins == -1 && next) {
-                static char hcal_buf[48];
-                snprintf(hcal_buf, sizeof(hcal_buf), LV_SYMBOL_BELL " %s (now)", next->title);
-                lv_label_set_text(home_calendar_label, hcal_buf);
-            } else if (mins >= 0 && mins <= 60 && next) {
-                static char hcal_buf[48];
-                snprintf(hcal_buf, sizeof(hcal_buf), LV_SYMBOL_BELL " %s in %dm", next->title, mins);
-                lv_label_set_text(home_calendar_label, hcal_buf);
-            } else if (next) {
-                static char hcal_buf[48];
-                snprintf(hcal_buf, sizeof(hcal_buf), LV_SYMBOL_BELL " %s %s", next->title, next->start_str);
-                lv_label_set_text(home_calendar_label, hcal_buf);
-            } else {
-                lv_label_set_text(home_calendar_label, "");
-            }
-        }
-        xSemaphoreGive(lvgl_mux);
-    }
-}
-
-// Public function: update Jira hours display when new data arrives
-void jira_hours_update_ui(void) {
-    if (xSemaphoreTake(lvgl_mux, pdMS_TO_TICKS(100)) == pdTRUE) {
-        if (jira_hours_data_is_synced() && home_jira_hours_label) {
-            const jira_hours_state_t* h = jira_hours_data_get();
-            if (h->target_min > 0) {
-                float logged = h->logged_min / 60.0f;
-                float target = h->target_min / 60.0f;
-                static char jhbuf2[24];
-                snprintf(jhbuf2, sizeof(jhbuf2), "%.1f / %.1fh", logged, target);
-                lv_label_set_text(home_jira_hours_label, jhbuf2);
-
-                if (h->logged_min >= h->target_min) {
-                    lv_obj_set_style_text_color(home_jira_hours_label, lv_color_hex(0x2ecc71), 0);
-                } else if (h->logged_min >= (h->target_min * 3 / 4)) {
-                    lv_obj_set_style_text_color(home_jira_hours_label, lv_color_hex(0xf39c12), 0);
-                } else {
-                    lv_obj_set_style_text_color(home_jira_hours_label, COLOR_TEXT_DIM, 0);
-                }
-            } else {
-                lv_label_set_text(home_jira_hours_label, "");
-            }
-        }
-        xSemaphoreGive(lvgl_mux);
+// Data bus subscriber
+static void calendar_screen_data_changed(uint32_t topics) {
+    if (current_screen == SCREEN_CALENDAR) {
+        update_calendar_display();
     }
 }
 
@@ -3943,6 +4022,13 @@ void lcd_lvgl_Init(void)
     create_menu_ui();
     // Create settings overlay (on top of menu)
     create_settings_ui();
+    // Hand data store changes to the subscribed screens
+    data_bus_subscribe(DATA_TOPIC_WEATHER | DATA_TOPIC_CALENDAR | DATA_TOPIC_JIRA_HOURS,
+                       home_data_changed);
+    data_bus_subscribe(DATA_TOPIC_JIRA, jira_screen_data_changed);
+    data_bus_subscribe(DATA_TOPIC_WEATHER, weather_screen_data_changed);
+    data_bus_subscribe(DATA_TOPIC_CALENDAR, calendar_screen_data_changed);
+    lv_timer_create(data_bus_timer_cb, 50, NULL);
 
     // ── Apply press feedback to all buttons ──
     apply_btn_press_style(btn_continue);
@@ -39,27 +39,15 @@ bool is_jira_screen_active(void);
 bool is_jira_timer_screen_active(void);
 bool is_jira_picker_open(void);
 
-// Called by USB sync when Jira project data arrives
-void jira_update_projects_ui(void);
-
 // Called by USB sync when Jira log response arrives
 void jira_update_log_status(bool success, const char* message);
 
-// Called by USB sync when weather data arrives
-void weather_update_ui(void);
-
 // Weather screen state check
 bool is_weather_screen_active(void);
 
-// Called by USB sync when calendar data arrives
-void calendar_update_ui(void);
-
 // Calendar screen state check
 bool is_calendar_screen_active(void);
 
-// Called by USB sync when Jira hours data arrives
-void jira_hours_update_ui(void);
-
 // BTS Quiz screen state check
 bool is_bts_quiz_screen_active(void);
 
@@ -0,0 +1,58 @@
+/*
+ * Double-buffered store with lock-free readers
+ *
+ * Seqlock ordering: the writer marks the back buffer odd before touching
+ * it and even (release) when done, then swaps the live index (release).
+ * A reader loads the index and that buffer's counter (acquire), copies,
+ * and re-checks the counter after an acquire fence.
+ */
+
+#include "snapshot.h"
+#include <string.h>
+
+void snapshot_init(snapshot_t* s, void* a, void* b, size_t size) {
+    memset(a, 0, size);
+    memset(b, 0, size);
+    s->buf[0] = a;
+    s->buf[1] = b;
+    s->size = size;
+    s->seq[0] = 0;
+    s->seq[1] = 0;
+    s->live = 0;
+}
+
+void* snapshot_begin_write(snapshot_t* s) {
+    uint8_t live = __atomic_load_n(&s->live, __ATOMIC_RELAXED);
+    uint8_t back = live ^ 1;
+
+    __atomic_store_n(&s->seq[back], s->seq[back] + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    memcpy(s->buf[back], s->buf[live], s->size);
+    return s->buf[back];
+}
+
+bool snapshot_publish(snapshot_t* s) {
+    uint8_t live = __atomic_load_n(&s->live, __ATOMIC_RELAXED);
+    uint8_t back = live ^ 1;
+    bool changed = memcmp(s->buf[back], s->buf[live], s->size) != 0;
+
+    __atomic_store_n(&s->seq[back], s->seq[back] + 1, __ATOMIC_RELEASE);
+    if (changed) __atomic_store_n(&s->live, back, __ATOMIC_RELEASE);
+    return changed;
+}
+
+void snapshot_read(snapshot_t* s, void* out) {
+    for (;;) {
+        uint8_t live = __atomic_load_n(&s->live, __ATOMIC_ACQUIRE);
+        uint32_t seq = __atomic_load_n(&s->seq[live], __ATOMIC_ACQUIRE);
+        if (seq & 1) continue;  // Already being rewritten - live has moved on
+
+        memcpy(out, s->buf[live], s->size);
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if (__atomic_load_n(&s->seq[live], __ATOMIC_RELAXED) == seq) return;
+    }
+}
+
+const void* snapshot_live(snapshot_t* s) {
+    return s->buf[__atomic_load_n(&s->live, __ATOMIC_ACQUIRE)];
+}
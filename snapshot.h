@@ -0,0 +1,57 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+/*
+ * Double-buffered store with lock-free readers
+ *
+ * The writer fills the back buffer (starting from a copy of the live one)
+ * and publishes it with one index swap, so it never waits for readers.
+ * Each buffer has a sequence counter that is odd while it is being
+ * written; snapshot_read() copies the live buffer and retries if the
+ * writer reused it meanwhile (two publications during one copy).
+ *
+ * One writer at a time - the data stores are written from the USB parser
+ * task only. Any number of readers.
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+    void* buf[2];
+    size_t size;
+    uint32_t seq[2];  // Per buffer, odd while it is being written
+    uint8_t live;     // Buffer readers use
+} snapshot_t;
+
+// Static initializer over two zero-initialized buffers, a live - lets
+// readers run before the owning module's init
+#define SNAPSHOT_INITIALIZER(a, b) { { (a), (b) }, sizeof(*(a)), { 0, 0 }, 0 }
+
+// Set up over two buffers of size bytes; both are zeroed, a is live
+void snapshot_init(snapshot_t* s, void* a, void* b, size_t size);
+
+// Writer: back buffer holding a copy of the live state, to be modified
+void* snapshot_begin_write(snapshot_t* s);
+
+// Writer: make the buffer from snapshot_begin_write() live. Returns false
+// (and keeps the old buffer live) if the contents did not change.
+bool snapshot_publish(snapshot_t* s);
+
+// Reader: consistent copy of the live state into out (size bytes)
+void snapshot_read(snapshot_t* s, void* out);
+
+// Reader: the live buffer itself - single fields only, it may be reused
+// by the writer after the next publication
+const void* snapshot_live(snapshot_t* s);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SNAPSHOT_H
@@ -22,7 +22,10 @@
  * }
  */
 
+#define LOG_TAG "TimeLog"
 #include "time_log.h"
+#include "debug_log.h"
+#include "json_arena.h"
 #include <Arduino.h>
 #include <LittleFS.h>
 #include <ArduinoJson.h>
@@ -42,24 +45,24 @@ static bool is_consecutive_day(const daily_log_t* day1, const daily_log_t* day2)
 
 // Initialize the time logging system
 void time_log_init(void) {
-    Serial.println("TimeLog: Initializing...");
+    LOGI("Initializing...");
 
     // Initialize LittleFS
     if (!LittleFS.begin(true)) {  // true = format if mount fails
-        Serial.println("TimeLog: LittleFS mount failed!");
+        LOGE("LittleFS mount failed!");
         g_time_log.initialized = false;
         return;
     }
-    Serial.println("TimeLog: LittleFS mounted");
+    LOGI("LittleFS mounted");
 
     // Clear the log structure
     memset(&g_time_log, 0, sizeof(g_time_log));
 
     // Try to load existing log
     if (time_log_load()) {
-        Serial.println("TimeLog: Loaded existing log");
+        LOGI("Loaded existing log");
     } else {
-        Serial.println("TimeLog: Starting fresh log");
+        LOGI("Starting fresh log");
     }
 
     // Ensure today's entry exists
@@ -69,7 +72,7 @@ void time_log_init(void) {
     calculate_streak();
 
     g_time_log.initialized = true;
-    Serial.printf("TimeLog: Ready. Streak: %d days\n", g_time_log.current_streak);
+    LOGI("Ready. Streak: %d days", g_time_log.current_streak);
 }
 
 // Get current date from system time
@@ -181,14 +184,14 @@ static void calculate_streak(void) {
 // Log a completed session
 bool time_log_add_session(session_type_t type, uint16_t duration_minutes) {
     if (!g_time_log.initialized) {
-        Serial.println("TimeLog: Not initialized!");
+        LOGW("Not initialized!");
         return false;
     }
 
     ensure_today_exists();
     int idx = find_today_index();
     if (idx < 0) {
-        Serial.println("TimeLog: Failed to find today's entry!");
+        LOGW("Failed to find today's entry!");
         return false;
     }
 
@@ -196,7 +199,7 @@ bool time_log_add_session(session_type_t type, uint16_t duration_minutes) {
 
     // Check if we have room for more sessions
     if (today->session_count >= MAX_SESSIONS_PER_DAY) {
-        Serial.println("TimeLog: Max sessions reached for today");
+        LOGW("Max sessions reached for today");
         // Still update totals even if we can't store the session detail
     } else {
         // Get current time for end time
@@ -225,11 +228,11 @@ bool time_log_add_session(session_type_t type, uint16_t duration_minutes) {
     if (type == SESSION_WORK) {
         today->total_work_minutes += duration_minutes;
         today->pomodoros_completed++;
-        Serial.printf("TimeLog: Work session logged. Total: %d min, Pomos: %d\n",
+        LOGI("Work session logged. Total: %d min, Pomos: %d",
                      today->total_work_minutes, today->pomodoros_completed);
     } else {
         today->total_break_minutes += duration_minutes;
-        Serial.printf("TimeLog: Break session logged. Total breaks: %d min\n",
+        LOGI("Break session logged. Total breaks: %d min",
                      today->total_break_minutes);
     }
 
@@ -268,11 +271,11 @@ const daily_log_t* time_log_get_today(void) {
 
 // Save log to flash storage
 bool time_log_save(void) {
-    Serial.println("TimeLog: Saving to flash...");
+    LOGI("Saving to flash...");
 
     // Create JSON document
     // Size calculation: base + (days * (date + sessions + stats))
-    StaticJsonDocument<4096> doc;
+    ArenaJsonDocument doc(4096);
 
     doc["streak"] = g_time_log.current_streak;
 
@@ -319,38 +322,38 @@ bool time_log_save(void) {
     // Write to file
     File file = LittleFS.open(TIME_LOG_FILE, "w");
     if (!file) {
-        Serial.println("TimeLog: Failed to open file for writing!");
+        LOGE("Failed to open file for writing!");
         return false;
     }
 
     size_t written = serializeJson(doc, file);
     file.close();
 
-    Serial.printf("TimeLog: Saved %d bytes\n", written);
+    LOGI("Saved %u bytes", (unsigned)written);
     return written > 0;
 }
 
 // Load log from flash storage
 bool time_log_load(void) {
-    Serial.println("TimeLog: Loading from flash...");
+    LOGI("Loading from flash...");
 
     if (!LittleFS.exists(TIME_LOG_FILE)) {
-        Serial.println("TimeLog: No existing log file");
+        LOGW("No existing log file");
         return false;
     }
 
     File file = LittleFS.open(TIME_LOG_FILE, "r");
     if (!file) {
-        Serial.println("TimeLog: Failed to open file for reading!");
+        LOGE("Failed to open file for reading!");
         return false;
     }
 
-    StaticJsonDocument<4096> doc;
+    ArenaJsonDocument doc(4096);
     DeserializationError error = deserializeJson(doc, file);
     file.close();
 
     if (error) {
-        Serial.printf("TimeLog: JSON parse error: %s\n", error.c_str());
+        LOGW("JSON parse error: %s", error.c_str());
         return false;
     }
 
@@ -406,7 +409,7 @@ bool time_log_load(void) {
         g_time_log.day_count++;
     }
 
-    Serial.printf("TimeLog: Loaded %d days of history\n", g_time_log.day_count);
+    LOGI("Loaded %d days of history", g_time_log.day_count);
     return true;
 }
 
@@ -0,0 +1,36 @@
+/*
+ * Runs the fuzz target over input files without libFuzzer - for
+ * reproducing a crash in a g++ build or under a debugger. The device's
+ * replies go to stdout.
+ *
+ *   ./fuzz_replay crash-1234 ...
+ */
+
+#include "host_shim.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <vector>
+
+extern "C" int LLVMFuzzerInitialize(int* argc, char*** argv);
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size);
+
+int main(int argc, char** argv) {
+    LLVMFuzzerInitialize(&argc, &argv);
+    host_serial_open(STDOUT_FILENO);
+    for (int i = 1; i < argc; i++) {
+        FILE* f = fopen(argv[i], "rb");
+        if (!f) {
+            perror(argv[i]);
+            return 1;
+        }
+        std::vector<uint8_t> data;
+        int c;
+        while ((c = fgetc(f)) != EOF) data.push_back((uint8_t)c);
+        fclose(f);
+
+        fprintf(stderr, "%s: %zu bytes\n", argv[i], data.size());
+        LLVMFuzzerTestOneInput(data.data(), data.size());
+    }
+    return 0;
+}
@@ -0,0 +1,38 @@
+/*
+ * libFuzzer target for the USB sync command dispatcher
+ *
+ * Each input is one command line as the framer hands it over - NUL
+ * terminated, binary payloads may hold NULs - and goes through
+ * handle_command() to dispatch_command() and the registered handlers of
+ * every data module. usb_sync.cpp is compiled into this file to reach
+ * those static functions.
+ *
+ * Nothing runs on other threads (host_tasks_enabled = false), and LittleFS
+ * is a fresh temporary directory, so an input replays the same way.
+ */
+
+#include "usb_sync.cpp"
+#include "host_shim.h"
+#include <stdlib.h>
+
+extern "C" int LLVMFuzzerInitialize(int* argc, char*** argv) {
+    static char fs_dir[] = "/tmp/focusknob_fuzz_XXXXXX";
+    if (!mkdtemp(fs_dir)) abort();
+    host_fs_root(fs_dir);
+    host_tasks_enabled = false;
+    host_boot();
+    return 0;
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+    // The framer never hands over more than its buffer holds
+    if (size >= USB_SYNC_BUFFER_SIZE) return 0;
+
+    // Exact-size heap copy so ASan sees any read past the terminator
+    char* line = (char*)malloc(size + 1);
+    memcpy(line, data, size);
+    line[size] = '\0';
+    handle_command(line, size);
+    free(line);
+    return 0;
+}
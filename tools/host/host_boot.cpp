@@ -0,0 +1,28 @@
+/*
+ * Host boot - the sync half of FocusKnob.ino's setup()
+ */
+
+#include "host_shim.h"
+#include "json_arena.h"
+#include "time_log.h"
+#include "jira_data.h"
+#include "weather_data.h"
+#include "calendar_data.h"
+#include "jira_hours_data.h"
+#include "warm_start.h"
+#include "clock_sync.h"
+#include "usb_sync.h"
+
+void host_boot(void) {
+    // Same order as setup(); time_log_init() runs in lcd_lvgl_Init() there
+    // and mounts LittleFS
+    json_arena_init();
+    time_log_init();
+    jira_data_init();
+    weather_data_init();
+    calendar_data_init();
+    jira_hours_data_init();
+    warm_start_init();
+    clock_sync_init();
+    usb_sync_init();
+}
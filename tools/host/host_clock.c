@@ -0,0 +1,23 @@
+/*
+ * Host clock guard
+ *
+ * TIME and TIMESYNC set the device clock with settimeofday()/adjtime().
+ * On the host those would move the machine's clock (or fail without
+ * root), so these definitions take their place: the call succeeds and the
+ * host clock, already right, is left alone.
+ */
+
+#include <stddef.h>
+#include <sys/time.h>
+
+int settimeofday(const struct timeval* tv, const struct timezone* tz) {
+    return 0;
+}
+
+int adjtime(const struct timeval* delta, struct timeval* olddelta) {
+    if (olddelta) {
+        olddelta->tv_sec = 0;
+        olddelta->tv_usec = 0;
+    }
+    return 0;
+}
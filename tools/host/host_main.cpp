@@ -0,0 +1,54 @@
+/*
+ * focusknob_host - the sync firmware on a pty
+ *
+ * Runs usb_sync and the data modules on Linux with Serial on the master
+ * side of a pseudo-terminal, and prints the slave path. Point the
+ * companion or tools/sync_bench.py at it:
+ *
+ *   ./focusknob_host [fs dir]          ->  /dev/pts/7
+ *   python3 tools/sync_bench.py --port /dev/pts/7 latency
+ *
+ * LittleFS files (note ring, time log, warm start) go to fs dir
+ * (default ./littlefs), so they survive restarts like flash does.
+ */
+
+#include "host_shim.h"
+#include "usb_sync.h"
+#include <Arduino.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <termios.h>
+#include <unistd.h>
+
+int main(int argc, char** argv) {
+    if (argc > 1) host_fs_root(argv[1]);
+
+    int master = posix_openpt(O_RDWR | O_NOCTTY);
+    if (master < 0 || grantpt(master) != 0 || unlockpt(master) != 0) {
+        perror("posix_openpt");
+        return 1;
+    }
+    const char* slave_path = ptsname(master);
+
+    // Raw slave, held open so the master never reads EOF between clients
+    int slave = open(slave_path, O_RDWR | O_NOCTTY);
+    struct termios tio;
+    if (slave < 0 || tcgetattr(slave, &tio) != 0) {
+        perror(slave_path);
+        return 1;
+    }
+    cfmakeraw(&tio);
+    tcsetattr(slave, TCSANOW, &tio);
+    fcntl(master, F_SETFL, fcntl(master, F_GETFL) | O_NONBLOCK);
+
+    host_serial_open(master);
+    host_boot();
+    printf("%s\n", slave_path);
+    fflush(stdout);
+
+    for (;;) {
+        usb_sync_process();
+        delay(10);
+    }
+}
@@ -0,0 +1,358 @@
+/*
+ * Host Shim Implementation
+ *
+ * Arduino core, LittleFS, heap_caps, esp_timer and FreeRTOS pieces the
+ * sync modules use, on top of POSIX and std::thread. See host_shim.h.
+ */
+
+#include "host_shim.h"
+#include "host_lcd_bsp.h"
+#include <Arduino.h>
+#include <LittleFS.h>
+#include <esp_heap_caps.h>
+#include <esp_timer.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include <stdarg.h>
+#include <errno.h>
+#include <poll.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/stat.h>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+
+// Longest a Serial write waits for the reader before dropping the rest,
+// like the CDC TX timeout on the device
+#define HOST_SERIAL_TX_TIMEOUT_MS 100
+
+bool host_tasks_enabled = true;
+
+static int g_serial_fd = -1;
+static std::string g_fs_root = "littlefs";
+static const auto g_boot = std::chrono::steady_clock::now();
+
+HWCDC Serial;
+FS LittleFS;
+
+void host_serial_open(int fd) {
+    g_serial_fd = fd;
+}
+
+void host_fs_root(const char* dir) {
+    g_fs_root = dir;
+}
+
+// ---------------------------------------------------------------------------
+// Arduino core
+
+size_t Print::printf(const char* fmt, ...) {
+    char small[256];
+    va_list args;
+    va_start(args, fmt);
+    int n = vsnprintf(small, sizeof(small), fmt, args);
+    va_end(args);
+    if (n < 0) return 0;
+    if ((size_t)n < sizeof(small)) return write((const uint8_t*)small, n);
+
+    std::string big(n + 1, '\0');
+    va_start(args, fmt);
+    vsnprintf(&big[0], big.size(), fmt, args);
+    va_end(args);
+    return write((const uint8_t*)big.data(), n);
+}
+
+int HWCDC::available() {
+    int n = 0;
+    if (g_serial_fd < 0 || ioctl(g_serial_fd, FIONREAD, &n) != 0) return 0;
+    return n;
+}
+
+int HWCDC::read() {
+    uint8_t c;
+    return readBytes((char*)&c, 1) == 1 ? c : -1;
+}
+
+size_t HWCDC::readBytes(char* buffer, size_t len) {
+    if (g_serial_fd < 0 || len == 0) return 0;
+    ssize_t got = ::read(g_serial_fd, buffer, len);
+    return got > 0 ? (size_t)got : 0;
+}
+
+size_t HWCDC::write(const uint8_t* data, size_t len) {
+    if (g_serial_fd < 0) return len;
+
+    size_t sent = 0;
+    while (sent < len) {
+        struct pollfd pfd = { g_serial_fd, POLLOUT, 0 };
+        if (poll(&pfd, 1, HOST_SERIAL_TX_TIMEOUT_MS) <= 0) break;
+        ssize_t n = ::write(g_serial_fd, data + sent, len - sent);
+        if (n < 0) {
+            if (errno == EAGAIN || errno == EINTR) continue;
+            break;
+        }
+        sent += n;
+    }
+    return sent;
+}
+
+unsigned long millis(void) {
+    return (unsigned long)(esp_timer_get_time() / 1000);
+}
+
+unsigned long micros(void) {
+    return (unsigned long)esp_timer_get_time();
+}
+
+void delay(unsigned long ms) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+// ---------------------------------------------------------------------------
+// LittleFS
+
+static std::string fs_path(const char* path) {
+    return g_fs_root + (path[0] == '/' ? "" : "/") + path;
+}
+
+File::File(FILE* fp) : _fp(fp, fclose) {}
+
+size_t File::size() {
+    struct stat st;
+    if (!_fp || fstat(fileno(_fp.get()), &st) != 0) return 0;
+    return st.st_size;
+}
+
+size_t File::position() {
+    if (!_fp) return 0;
+    long pos = ftell(_fp.get());
+    return pos < 0 ? 0 : (size_t)pos;
+}
+
+bool File::seek(uint32_t pos) {
+    return _fp && fseek(_fp.get(), pos, SEEK_SET) == 0;
+}
+
+int File::available() {
+    return (int)(size() - position());
+}
+
+int File::read() {
+    return _fp ? fgetc(_fp.get()) : -1;
+}
+
+size_t File::read(uint8_t* buffer, size_t len) {
+    return _fp ? fread(buffer, 1, len, _fp.get()) : 0;
+}
+
+size_t File::readBytes(char* buffer, size_t len) {
+    return read((uint8_t*)buffer, len);
+}
+
+size_t File::write(const uint8_t* data, size_t len) {
+    if (!_fp) return 0;
+    // stdio needs a seek between a read and a write, a flush the other way
+    fseek(_fp.get(), 0, SEEK_CUR);
+    size_t n = fwrite(data, 1, len, _fp.get());
+    fflush(_fp.get());
+    return n;
+}
+
+bool FS::begin(bool format_if_failed) {
+    return mkdir(g_fs_root.c_str(), 0755) == 0 || errno == EEXIST;
+}
+
+File FS::open(const char* path, const char* mode) {
+    std::string m = mode;
+    const char* stdio_mode = m == "w" ? "wb" : m == "a" ? "ab" : m == "r+" ? "r+b" :
+                             m == "w+" ? "w+b" : m == "a+" ? "a+b" : "rb";
+    FILE* fp = fopen(fs_path(path).c_str(), stdio_mode);
+    return fp ? File(fp) : File();
+}
+
+bool FS::exists(const char* path) {
+    return access(fs_path(path).c_str(), F_OK) == 0;
+}
+
+bool FS::remove(const char* path) {
+    return ::remove(fs_path(path).c_str()) == 0;
+}
+
+bool FS::rename(const char* from, const char* to) {
+    return ::rename(fs_path(from).c_str(), fs_path(to).c_str()) == 0;
+}
+
+// ---------------------------------------------------------------------------
+// heap_caps
+
+void* heap_caps_malloc(size_t size, uint32_t caps) {
+    return malloc(size);
+}
+
+void heap_caps_free(void* ptr) {
+    free(ptr);
+}
+
+size_t heap_caps_get_free_size(uint32_t caps) {
+    return (caps & MALLOC_CAP_SPIRAM) ? 8 * 1024 * 1024 : 256 * 1024;
+}
+
+// ---------------------------------------------------------------------------
+// esp_timer
+
+struct esp_timer {
+    esp_timer_create_args_t args;
+};
+
+int64_t esp_timer_get_time(void) {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - g_boot).count();
+}
+
+esp_err_t esp_timer_create(const esp_timer_create_args_t* args, esp_timer_handle_t* out) {
+    *out = new esp_timer{*args};
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_start_periodic(esp_timer_handle_t timer, uint64_t period_us) {
+    if (!host_tasks_enabled) return ESP_FAIL;
+    std::thread([timer, period_us] {
+        for (;;) {
+            std::this_thread::sleep_for(std::chrono::microseconds(period_us));
+            timer->args.callback(timer->args.arg);
+        }
+    }).detach();
+    return ESP_OK;
+}
+
+// ---------------------------------------------------------------------------
+// FreeRTOS tasks
+
+struct host_task {
+    std::mutex mux;
+    std::condition_variable cv;
+    uint32_t notify = 0;
+};
+
+static thread_local host_task* t_self = NULL;
+
+static host_task* self_task(void) {
+    if (!t_self) t_self = new host_task;  // main() or a timer thread
+    return t_self;
+}
+
+BaseType_t xTaskCreate(TaskFunction_t fn, const char* name, uint32_t stack_depth,
+                       void* arg, UBaseType_t priority, TaskHandle_t* out) {
+    if (!host_tasks_enabled) return pdFAIL;
+    host_task* task = new host_task;
+    if (out) *out = task;
+    std::thread([task, fn, arg, name] {
+        t_self = task;
+        pthread_setname_np(pthread_self(), std::string(name).substr(0, 15).c_str());
+        fn(arg);
+    }).detach();
+    return pdPASS;
+}
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t fn, const char* name, uint32_t stack_depth,
+                                   void* arg, UBaseType_t priority, TaskHandle_t* out, int core) {
+    return xTaskCreate(fn, name, stack_depth, arg, priority, out);
+}
+
+// A thread can only end itself; deleting another task is not supported
+void vTaskDelete(TaskHandle_t task) {
+    if (!task || task == t_self) pthread_exit(NULL);
+    fprintf(stderr, "host: vTaskDelete of another task ignored\n");
+}
+
+void vTaskDelay(TickType_t ticks) {
+    delay(ticks ? ticks : 1);
+}
+
+TickType_t xTaskGetTickCount(void) {
+    return (TickType_t)millis();
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void) {
+    return self_task();
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t handle) {
+    host_task* task = (host_task*)handle;
+    {
+        std::lock_guard<std::mutex> lock(task->mux);
+        task->notify++;
+    }
+    task->cv.notify_one();
+    return pdPASS;
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clear_on_exit, TickType_t ticks) {
+    host_task* task = self_task();
+    std::unique_lock<std::mutex> lock(task->mux);
+    auto ready = [task] { return task->notify != 0; };
+    if (ticks == portMAX_DELAY) {
+        task->cv.wait(lock, ready);
+    } else {
+        task->cv.wait_for(lock, std::chrono::milliseconds(ticks), ready);
+    }
+    uint32_t value = task->notify;
+    if (value) task->notify = clear_on_exit ? 0 : value - 1;
+    return value;
+}
+
+// ---------------------------------------------------------------------------
+// FreeRTOS mutexes
+
+// A FreeRTOS mutex handle is used either plain or recursive, never both
+struct host_sem {
+    std::timed_mutex plain;
+    std::recursive_timed_mutex nested;
+};
+
+template <typename M>
+static BaseType_t sem_take(M& mux, TickType_t ticks) {
+    if (ticks == portMAX_DELAY) {
+        mux.lock();
+        return pdTRUE;
+    }
+    return mux.try_lock_for(std::chrono::milliseconds(ticks)) ? pdTRUE : pdFALSE;
+}
+
+SemaphoreHandle_t xSemaphoreCreateMutex(void) {
+    return new host_sem;
+}
+
+SemaphoreHandle_t xSemaphoreCreateRecursiveMutex(void) {
+    return new host_sem;
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t handle, TickType_t ticks) {
+    return sem_take(((host_sem*)handle)->plain, ticks);
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t handle) {
+    ((host_sem*)handle)->plain.unlock();
+    return pdTRUE;
+}
+
+BaseType_t xSemaphoreTakeRecursive(SemaphoreHandle_t handle, TickType_t ticks) {
+    return sem_take(((host_sem*)handle)->nested, ticks);
+}
+
+BaseType_t xSemaphoreGiveRecursive(SemaphoreHandle_t handle) {
+    ((host_sem*)handle)->nested.unlock();
+    return pdTRUE;
+}
+
+// ---------------------------------------------------------------------------
+// Display (lcd_bsp)
+
+void jira_update_log_status(bool success, const char* message) {
+    fprintf(stderr, "host: Jira log %s: %s\n", success ? "ok" : "failed", message ? message : "");
+}
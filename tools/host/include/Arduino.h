@@ -0,0 +1,75 @@
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+/*
+ * Host Arduino core shim
+ *
+ * Just enough of the ESP32 Arduino core for usb_sync and the data modules
+ * to build on Linux. Serial reads and writes a file descriptor (a pty
+ * master in focusknob_host), see host_shim.h.
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <algorithm>
+// The ESP32 core pulls these in for every sketch file
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+
+using std::min;
+using std::max;
+
+class Print {
+public:
+    virtual ~Print() {}
+    virtual size_t write(const uint8_t* data, size_t len) = 0;
+    size_t write(uint8_t c) { return write(&c, 1); }
+    size_t write(const char* s) { return write((const uint8_t*)s, strlen(s)); }
+    size_t print(const char* s) { return write(s); }
+    size_t print(char c) { return write((uint8_t)c); }
+    size_t print(int v) { return printf("%d", v); }
+    size_t print(unsigned int v) { return printf("%u", v); }
+    size_t print(long v) { return printf("%ld", v); }
+    size_t print(unsigned long v) { return printf("%lu", v); }
+    size_t println(const char* s = "") { return print(s) + print('\n'); }
+    size_t printf(const char* fmt, ...) __attribute__((format(printf, 2, 3)));
+    void flush() {}
+};
+
+class Stream : public Print {
+public:
+    virtual int available() = 0;
+    virtual int read() = 0;
+    virtual size_t readBytes(char* buffer, size_t len) = 0;
+    size_t readBytes(uint8_t* buffer, size_t len) { return readBytes((char*)buffer, len); }
+    void setTimeout(unsigned long) {}
+};
+
+// USB CDC port
+class HWCDC : public Stream {
+public:
+    void begin(unsigned long) {}
+    void setRxBufferSize(size_t) {}
+    void setTxTimeoutMs(uint32_t) {}
+    operator bool() const { return true; }
+
+    int available() override;
+    int read() override;
+    size_t readBytes(char* buffer, size_t len) override;
+    size_t write(const uint8_t* data, size_t len) override;
+    using Print::write;
+};
+
+extern HWCDC Serial;
+
+unsigned long millis(void);
+unsigned long micros(void);
+void delay(unsigned long ms);
+
+#endif // HOST_ARDUINO_H
@@ -0,0 +1,46 @@
+#ifndef HOST_LITTLEFS_H
+#define HOST_LITTLEFS_H
+
+/*
+ * Host LittleFS shim - files live in a directory on the host
+ * (host_fs_root(), default ./littlefs)
+ */
+
+#include "Arduino.h"
+#include <memory>
+
+class File : public Stream {
+public:
+    File() {}
+    explicit File(FILE* fp);
+
+    operator bool() const { return (bool)_fp; }
+    void close() { _fp.reset(); }
+    size_t size();
+    size_t position();
+    bool seek(uint32_t pos);
+
+    int available() override;
+    int read() override;
+    size_t read(uint8_t* buffer, size_t len);
+    size_t readBytes(char* buffer, size_t len) override;
+    size_t write(const uint8_t* data, size_t len) override;
+    using Print::write;
+
+private:
+    // Shared like the Arduino handle - copies refer to the same open file
+    std::shared_ptr<FILE> _fp;
+};
+
+class FS {
+public:
+    bool begin(bool format_if_failed = false);
+    File open(const char* path, const char* mode = "r");
+    bool exists(const char* path);
+    bool remove(const char* path);
+    bool rename(const char* from, const char* to);
+};
+
+extern FS LittleFS;
+
+#endif // HOST_LITTLEFS_H
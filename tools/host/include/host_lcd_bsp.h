@@ -0,0 +1,22 @@
+#ifndef HOST_LCD_BSP_H
+#define HOST_LCD_BSP_H
+
+// Stands in for lcd_bsp.h (force-included, and defines its include guard)
+// - the host build has no display; only what the sync modules call
+
+#define LCD_BSP_H
+
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Called by USB sync when Jira log response arrives
+void jira_update_log_status(bool success, const char* message);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HOST_LCD_BSP_H
@@ -0,0 +1,36 @@
+#ifndef HOST_SHIM_H
+#define HOST_SHIM_H
+
+/*
+ * Host shim controls
+ *
+ * The host build runs usb_sync.cpp and the data modules unchanged on
+ * Linux. Serial is a file descriptor, LittleFS a directory, FreeRTOS tasks
+ * and esp_timer threads. The device clock is an offset on the host clock:
+ * settimeofday()/adjtime() from TIME and TIMESYNC move only that.
+ */
+
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Serial reads and writes fd; -1 (the default) reads nothing and drops output
+void host_serial_open(int fd);
+
+// Directory LittleFS files live in (default ./littlefs, created by begin())
+void host_fs_root(const char* dir);
+
+// false: xTaskCreate() and periodic timers fail, so nothing runs behind the
+// caller's back - usb_sync falls back to polling from usb_sync_process()
+extern bool host_tasks_enabled;
+
+// Initialize the sync modules in FocusKnob.ino's setup() order
+void host_boot(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HOST_SHIM_H
@@ -0,0 +1,465 @@
+#!/usr/bin/env python3
+"""
+USB sync protocol bench and fuzzer for a connected FocusKnob.
+
+Drives the firmware's usb_sync parser over the CDC link (or the host
+build's pty):
+  throughput  pipelined commands: commands/sec and bytes/sec (host and device view)
+  latency     sequential PING round trips: p50/p95/p99/max, then CMD_STATS
+  encoding    JSON vs MessagePack data payloads: bytes on the wire and
+              device parse time (STATS parse_* counters)
+  batch       BATCH splitting checks: a bare verb next to a binary
+              (MessagePack) segment must come back as separate requests
+  find        JIRA_FIND lookups over the loaded issues: device search time
+              (reported in the reply) and round trip per query
+  fuzz        random lines, verbs, frames and Z envelopes; checks PONG after
+              every batch and saves the batch that broke it
+
+On the device, fuzz finds hangs and reboots (no PONG). For memory errors
+run it against the host build instead - tools/host/focusknob_host runs
+the same usb_sync.cpp and data modules on a pty under ASan/UBSan
+(--port /dev/pts/N), and tools/host/fuzz_usb_sync is a libFuzzer target
+over the command dispatcher. Without --destructive only verbs that leave
+synced data, logged time and the clock alone are sent.
+
+Stop the sync service first - only one program can hold the port.
+
+Usage:
+    python3 sync_bench.py throughput [--count 2000] [--size 200]
+    python3 sync_bench.py latency [--count 500]
+    python3 sync_bench.py encoding [--count 50]
+    python3 sync_bench.py batch
+    python3 sync_bench.py find [--count 300] [--seed 1]
+    python3 sync_bench.py fuzz [--cases 5000] [--seed 1] [--destructive]
+"""
+
+import argparse
+import base64
+import json
+import os
+import random
+import sys
+import time
+from pathlib import Path
+
+import serial
+import serial.tools.list_ports
+
+# Reuse the companion's wire encoders so the bench speaks the same protocol
+sys.path.insert(0, str(Path(__file__).resolve().parent.parent / "companion"))
+from focusknob_sync import (  # noqa: E402
+    BATCH_SEP, build_frame, cobs_encode, msgpack_encode, z_envelope,
+)
+
+BAUD_RATE = 115200
+REPLY_TIMEOUT = 2.0
+FUZZ_BATCH = 20
+FRAME_DATA = 256
+
+# Verbs whose garbage payloads can't lose user data
+SAFE_VERBS = [
+    "PING", "STATS", "CMD_STATS", "FRAMED", "Z", "TIMESYNC", "GET_LOGS",
+    "JIRA_LOG_ERROR", "JIRA_FIND", "OK",
+]
+# Verbs that replace or edit synced data, count logged time, set the clock
+# or drop queued notes
+DESTRUCTIVE_VERBS = [
+    "TIME", "TIMEADJ", "NOTE_ACK", "JIRA_PROJECTS", "JIRA_PAGE_DATA", "JIRA_PATCH",
+    "JIRA_LOG_OK", "WEATHER", "CALENDAR", "JIRA_HOURS",
+]
+
+
+def find_port():
+    """Find the FocusKnob port by PING/PONG."""
+    for info in serial.tools.list_ports.comports():
+        try:
+            with serial.Serial(info.device, BAUD_RATE, timeout=0.5) as ser:
+                ser.reset_input_buffer()
+                ser.write(b"PING\n")
+                if wait_for(ser, "PONG", 1.0) is not None:
+                    return info.device
+        except (serial.SerialException, OSError):
+            continue
+    return None
+
+
+def wait_for(ser, prefix, timeout=REPLY_TIMEOUT):
+    """Read lines until one starts with prefix; returns it or None."""
+    deadline = time.time() + timeout
+    while time.time() < deadline:
+        line = ser.readline().decode("utf-8", errors="ignore").strip()
+        if line.startswith(prefix):
+            return line
+    return None
+
+
+def device_stats(ser):
+    """Fetch the device's STATS counters as a dict."""
+    ser.reset_input_buffer()
+    ser.write(b"STATS\n")
+    line = wait_for(ser, "STATS:")
+    return json.loads(line[6:]) if line else {}
+
+
+def percentile(sorted_values, pct):
+    if not sorted_values:
+        return 0.0
+    k = min(len(sorted_values) - 1, int(round(pct / 100.0 * (len(sorted_values) - 1))))
+    return sorted_values[k]
+
+
+def bench_throughput(ser, count, size):
+    """Pipeline count PING:<pad> lines, then time until the last PONG."""
+    pad = "x" * max(0, size - len("PING:") - 1)
+    line = f"PING:{pad}\n".encode()
+
+    before = device_stats(ser)
+    ser.reset_input_buffer()
+    start = time.perf_counter()
+    for _ in range(count):
+        ser.write(line)
+    ser.write(b"PING:end\n")
+    ser.flush()
+
+    pongs = 0
+    deadline = time.time() + REPLY_TIMEOUT + count * 0.01
+    while pongs <= count and time.time() < deadline:
+        reply = ser.readline().decode("utf-8", errors="ignore").strip()
+        if reply == "PONG":
+            pongs += 1
+    elapsed = time.perf_counter() - start
+    after = device_stats(ser)
+
+    total = (count + 1) * len(line)
+    print(f"  commands:     {count} x {len(line)} B, {pongs} PONG")
+    print(f"  host view:    {count / elapsed:,.0f} cmd/s, {total / elapsed / 1024:,.1f} KiB/s")
+    busy = after.get("busy_us", 0) - before.get("busy_us", 0)
+    rx = after.get("rx_bytes", 0) - before.get("rx_bytes", 0)
+    if busy > 0:
+        print(f"  device parse: {rx / (busy / 1e6) / 1024:,.1f} KiB/s "
+              f"({busy / 1000:.1f} ms busy for {rx} B)")
+    return 0 if pongs > count else 1
+
+
+def bench_latency(ser, count):
+    """Sequential PING round trips."""
+    samples = []
+    for _ in range(count):
+        ser.reset_input_buffer()
+        start = time.perf_counter()
+        ser.write(b"PING\n")
+        if wait_for(ser, "PONG") is None:
+            print("  PONG timeout")
+            return 1
+        samples.append((time.perf_counter() - start) * 1e6)
+
+    samples.sort()
+    print(f"  PING rtt over {count}: p50 {percentile(samples, 50):.0f} us, "
+          f"p95 {percentile(samples, 95):.0f} us, p99 {percentile(samples, 99):.0f} us, "
+          f"max {samples[-1]:.0f} us")
+
+    ser.write(b"CMD_STATS\n")
+    line = wait_for(ser, "CMD_STATS:")
+    if line:
+        print("  device arrival-to-handled latency (calls, avg us, max us):")
+        for verb, (n, avg, peak) in sorted(json.loads(line[10:]).items()):
+            print(f"    {verb:<16} {n:>8} {avg:>8} {peak:>8}")
+    return 0
+
+
+def send_framed(ser, seq, message):
+    """Send one message as frames and wait for its ACK."""
+    chunks = [message[i:i + FRAME_DATA] for i in range(0, len(message), FRAME_DATA)] or [b""]
+    ser.write(b"".join(build_frame(b"E" if i == len(chunks) - 1 else b"D", seq, i, c)
+                       for i, c in enumerate(chunks)))
+    return wait_for(ser, f"ACK:{seq}") is not None
+
+
+def sample_patch():
+    """A JIRA_PATCH body shaped like a real refresh of 12 issues."""
+    ops = []
+    for i in range(12):
+        ops.append({"op": "u", "key": f"PROJ-{1000 + i}",
+                    "name": f"Investigate sync latency regression in build {i}",
+                    "proj": "Platform Reliability", "status": "In Progress",
+                    "desc": "Parser time per command rose after the last release. "
+                            "Profile the USB task and compare against the baseline build."})
+    # base can't match the device's version, so the patch is parsed then refused
+    return {"base": 65535, "ver": 0, "ops": ops}
+
+
+def bench_encoding(ser, count):
+    """Parse the same JIRA_PATCH as JSON and as MessagePack."""
+    patch = sample_patch()
+    json_body = json.dumps(patch, separators=(",", ":")).encode()
+    mp_body = msgpack_encode(patch)
+    print(f"  payload: JSON {len(json_body)} B, MessagePack {len(mp_body)} B "
+          f"({100 * len(mp_body) / len(json_body):.0f}%)")
+
+    ser.write(b"FRAMED\n")
+    if wait_for(ser, "FRAMED_OK:") is None:
+        print("  Device has no framed transport")
+        return 1
+
+    before = device_stats(ser)
+    seq = 0
+    for _ in range(count):
+        for message in (b"JIRA_PATCH:" + json_body,
+                        b"JIRA_PATCH:M" + str(len(mp_body)).encode() + b":" + mp_body):
+            seq = (seq + 1) & 0xFF
+            if not send_framed(ser, seq, message) or wait_for(ser, "JIRA_PATCH_") is None:
+                print("  No reply to JIRA_PATCH")
+                return 1
+    after = device_stats(ser)
+
+    for name in ("json", "msgpack"):
+        nbytes = after.get(f"parse_{name}_bytes", 0) - before.get(f"parse_{name}_bytes", 0)
+        us = after.get(f"parse_{name}_us", 0) - before.get(f"parse_{name}_us", 0)
+        print(f"  device {name:<8} {nbytes // max(count, 1):>6} B/parse, {us / max(count, 1):>8.0f} us/parse")
+    return 0
+
+
+def read_until(ser, marker, timeout=REPLY_TIMEOUT):
+    """Lines up to and including marker, or None on timeout."""
+    lines = []
+    deadline = time.time() + timeout
+    while time.time() < deadline:
+        line = ser.readline().decode("utf-8", errors="ignore").strip()
+        if line:
+            lines.append(line)
+        if line == marker:
+            return lines
+    return None
+
+
+def check_batch(ser):
+    """Bare verbs around a binary segment must each get their own reply.
+
+    The connect-time sync sends "@1 GET_LOGS" ahead of "@2 WEATHER:M<n>:..."
+    in one BATCH; the bare verb's segment must end at its separator, not
+    borrow the next segment's binary length. The patch is refused by base,
+    and one value holds the separator byte to check the length skip too.
+    """
+    patch = {"base": 65535, "ver": 0, "ops": [{"op": "u", "key": "BENCH-1", "name": "a" + BATCH_SEP + "b"}]}
+    body = msgpack_encode(patch)
+    cases = {
+        "bare, binary, bare": [b"@1 PING", b"@2 JIRA_PATCH:M%d:" % len(body) + body, b"@3 PING"],
+        "binary first": [b"@1 JIRA_PATCH:M%d:" % len(body) + body, b"@2 PING"],
+        "bare verbs only": [b"@1 PING", b"@2 PING"],
+    }
+    expected = {"PING": "PONG", "JIRA_PATCH": "JIRA_PATCH_NAK:"}
+
+    ser.write(b"FRAMED\n")
+    if wait_for(ser, "FRAMED_OK:") is None:
+        print("  Device has no framed transport")
+        return 1
+
+    failed = 0
+    for seq, (name, segments) in enumerate(cases.items(), 1):
+        ser.reset_input_buffer()
+        message = b"BATCH:" + BATCH_SEP.encode().join(segments)
+        if not send_framed(ser, seq, message):
+            print(f"  {name}: no ACK")
+            return 1
+        lines = read_until(ser, f"END:{len(segments)}")
+        replies = []
+        for i, segment in enumerate(segments, 1):
+            verb = segment.split(b" ", 1)[1].split(b":", 1)[0].decode()
+            got = None
+            if lines and f"END:{i}" in lines:
+                end = lines.index(f"END:{i}")
+                got = next((line for line in lines[:end] if line.startswith(expected[verb])), None)
+                lines = lines[end + 1:]
+            replies.append(got is not None)
+        ok = all(replies)
+        failed += not ok
+        print(f"  {name:<20} {'ok' if ok else 'FAILED'}")
+    return 1 if failed else 0
+
+
+def jira_find(ser, query):
+    """One JIRA_FIND round trip: (device us, host us, matched keys) or None."""
+    ser.reset_input_buffer()
+    start = time.perf_counter()
+    ser.write(f"JIRA_FIND:{query}\n".encode())
+    line = wait_for(ser, "JIRA_FOUND:")
+    if line is None:
+        return None
+    rtt = (time.perf_counter() - start) * 1e6
+    device_us, _, keys = line[len("JIRA_FOUND:"):].partition(":")
+    return int(device_us), rtt, [k for k in keys.split(",") if k]
+
+
+def bench_find(ser, count, seed):
+    """Key fragments, exact keys and summary words against the device's index."""
+    rng = random.Random(seed)
+    # Seed the query mix with keys the device actually holds
+    keys = set()
+    for prefix in "ABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789":
+        found = jira_find(ser, prefix)
+        if found is None:
+            print("  No reply to JIRA_FIND")
+            return 1
+        keys.update(found[2])
+    if not keys:
+        print("  Device has no Jira issues loaded")
+        return 1
+    keys = sorted(keys)
+
+    kinds = {"exact key": [], "key fragment": [], "summary text": []}
+    for _ in range(count):
+        key = rng.choice(keys)
+        kind = rng.choice(list(kinds))
+        if kind == "exact key":
+            query = key
+        elif kind == "key fragment":
+            cut = rng.randrange(len(key))
+            query = key[cut:cut + rng.randint(2, 5)]
+        else:
+            query = random_word(rng)
+        found = jira_find(ser, query)
+        if found is None:
+            print(f"  No reply to JIRA_FIND:{query}")
+            return 1
+        kinds[kind].append(found)
+
+    print(f"  {len(keys)} keys sampled, {count} queries")
+    print("    kind            queries   dev p50   dev p99   dev max   rtt p50   (us)")
+    for kind, samples in kinds.items():
+        if not samples:
+            continue
+        dev = sorted(s[0] for s in samples)
+        rtt = sorted(s[1] for s in samples)
+        print(f"    {kind:<14} {len(samples):>8} {percentile(dev, 50):>9.0f} "
+              f"{percentile(dev, 99):>9.0f} {dev[-1]:>9.0f} {percentile(rtt, 50):>9.0f}")
+    return 0
+
+
+def random_word(rng):
+    """A lowercase 3-6 letter word, likely a fragment of some summary."""
+    return "".join(rng.choice("etaoinshrdlu") for _ in range(rng.randint(3, 6)))
+
+
+def random_text(rng, n):
+    """Printable-ish bytes without the line and frame delimiters."""
+    return bytes(rng.choice(range(1, 256)) for _ in range(n)).replace(b"\n", b" ")
+
+
+def fuzz_case(rng, verbs):
+    """One fuzz input as raw bytes to write."""
+    kind = rng.randrange(6)
+    if kind == 0:
+        # Known verb, garbage payload
+        return rng.choice(verbs).encode() + b":" + random_text(rng, rng.randrange(0, 300)) + b"\n"
+    if kind == 1:
+        # Known verb, JIRA_PATCH-shaped payload
+        body = json.dumps({"base": rng.randrange(-2, 5), "ver": rng.randrange(-2, 5),
+                           "ops": [{"op": rng.choice(["u", "d", "x"]), "key": "X-1",
+                                    "name": rng.random()}] * rng.randrange(3)})
+        return rng.choice(verbs).encode() + b":" + body.encode() + b"\n"
+    if kind == 2:
+        # Oversized line
+        return b"PING:" + b"A" * rng.randrange(8000, 9000) + b"\n"
+    if kind == 3:
+        # Valid frame with a flipped byte, or a truncated frame
+        data = random_text(rng, rng.randrange(1, FRAME_DATA))
+        frame = bytearray(build_frame(rng.choice([b"D", b"E"]), rng.randrange(256), rng.randrange(40), data))
+        if rng.random() < 0.5:
+            i = rng.randrange(1, len(frame) - 1)
+            frame[i] = rng.randrange(1, 256)
+        else:
+            frame = frame[:rng.randrange(1, len(frame))] + b"\x00"
+        return bytes(frame)
+    if kind == 4:
+        # Raw COBS garbage between delimiters
+        return b"\x00" + cobs_encode(random_text(rng, rng.randrange(1, 64))) + b"\x00"
+    # Z envelope with a corrupted header, length or body
+    packed = z_envelope("PING:" + "y" * rng.randrange(300, 2000))
+    head, raw_len, body = packed.split(":", 2)
+    mode = rng.randrange(3)
+    if mode == 0:
+        raw_len = str(rng.choice([0, 1, int(raw_len) + 1, 99999999]))
+    elif mode == 1:
+        raw = bytearray(base64.b64decode(body))
+        raw[rng.randrange(len(raw))] ^= 0xFF
+        body = base64.b64encode(bytes(raw)).decode()
+    else:
+        body = body[:rng.randrange(len(body))]
+    return f"{head}:{raw_len}:{body}\n".encode()
+
+
+def fuzz(ser, cases, seed, destructive):
+    """Send cases in batches; after each batch the device must still PONG."""
+    rng = random.Random(seed)
+    verbs = SAFE_VERBS + (DESTRUCTIVE_VERBS if destructive else [])
+    batch = []
+    for n in range(1, cases + 1):
+        case = fuzz_case(rng, verbs)
+        batch.append(case)
+        ser.write(case)
+
+        if n % FUZZ_BATCH == 0 or n == cases:
+            # Newline ends any half-open text line before the check
+            ser.write(b"\nPING\n")
+            if wait_for(ser, "PONG", 5.0) is None:
+                path = Path(f"sync_fuzz_seed{seed}_case{n}.bin")
+                path.write_bytes(b"".join(batch))
+                print(f"\n  No PONG after case {n} - batch saved to {path}")
+                return 1
+            ser.reset_input_buffer()
+            batch.clear()
+            print(f"\r  {n}/{cases} cases", end="", flush=True)
+
+    print(f"\n  Device survived {cases} cases (seed {seed})")
+    stats = device_stats(ser)
+    print(f"  frames ok/bad: {stats.get('rx_frames')}/{stats.get('rx_bad_frames')}, "
+          f"naks: {stats.get('rx_naks')}, truncated lines: {stats.get('rx_truncated')}")
+    return 0
+
+
+def main():
+    parser = argparse.ArgumentParser(description="FocusKnob USB sync bench and fuzzer")
+    parser.add_argument("--port", help="serial port (default: auto-detect)")
+    sub = parser.add_subparsers(dest="mode", required=True)
+    p = sub.add_parser("throughput")
+    p.add_argument("--count", type=int, default=2000)
+    p.add_argument("--size", type=int, default=200, help="bytes per command line")
+    p = sub.add_parser("latency")
+    p.add_argument("--count", type=int, default=500)
+    p = sub.add_parser("encoding")
+    p.add_argument("--count", type=int, default=50)
+    sub.add_parser("batch")
+    p = sub.add_parser("find")
+    p.add_argument("--count", type=int, default=300)
+    p.add_argument("--seed", type=int, default=1)
+    p = sub.add_parser("fuzz")
+    p.add_argument("--cases", type=int, default=5000)
+    p.add_argument("--seed", type=int, default=int.from_bytes(os.urandom(4), "little"))
+    p.add_argument("--destructive", action="store_true",
+                   help="also fuzz verbs that overwrite synced data, the clock or the note queue")
+    args = parser.parse_args()
+
+    port = args.port or find_port()
+    if not port:
+        print("ERROR: FocusKnob not found (is the sync service holding the port?)")
+        return 1
+    print(f"FocusKnob on {port} - {args.mode}")
+
+    with serial.Serial(port, BAUD_RATE, timeout=0.5) as ser:
+        time.sleep(0.2)
+        ser.reset_input_buffer()
+        if args.mode == "throughput":
+            return bench_throughput(ser, args.count, args.size)
+        if args.mode == "latency":
+            return bench_latency(ser, args.count)
+        if args.mode == "encoding":
+            return bench_encoding(ser, args.count)
+        if args.mode == "batch":
+            return check_batch(ser)
+        if args.mode == "find":
+            return bench_find(ser, args.count, args.seed)
+        return fuzz(ser, args.cases, args.seed, args.destructive)
+
+
+if __name__ == "__main__":
+    sys.exit(main())
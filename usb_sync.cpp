@@ -7,25 +7,124 @@
  * - Sending notes to Notion
  */
 
+#define LOG_TAG "USBSync"
 #include "usb_sync.h"
+#include "debug_log.h"
 #include "time_log.h"
-#include "jira_data.h"
+#include "json_arena.h"
+#include "warm_start.h"
 #include "jira_hours_data.h"
-#include "weather_data.h"
-#include "calendar_data.h"
+#include "jira_data.h"
+#include "data_bus.h"
 #include "lcd_bsp.h"
 #include <Arduino.h>
 #include <ArduinoJson.h>
+#include <LittleFS.h>
+#include <esp_heap_caps.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include <stddef.h>
+#include <stdarg.h>
 #include <time.h>
 #include <sys/time.h>
 
 // Serial command buffer
 static char g_serial_buffer[USB_SYNC_BUFFER_SIZE];
 static uint16_t g_buffer_index = 0;
+static bool g_discarding = false;  // Dropping the tail of an oversized line
+
+static bool g_in_frame = false;    // Pending segment is a binary frame
+
+// Framed transport reassembly (allocated on FRAMED negotiation)
+static char* g_frame_asm = NULL;
+static bool g_frame_active = false;
+static uint8_t g_frame_seq = 0;         // Message being reassembled
+static int16_t g_frame_done_seq = -1;   // Last message dispatched
+static uint32_t g_frame_have = 0;       // Bitmap of received fragments
+static int8_t g_frame_last = -1;        // Index of final fragment, -1 until seen
+static uint16_t g_frame_len = 0;
+
+// Decompression output for Z envelopes (allocated on first use)
+static char* g_z_out = NULL;
+
+// Streaming LZ4-block decoder state
+typedef enum {
+    Z_TOKEN, Z_LIT_EXT, Z_LITERALS, Z_OFF_LO, Z_OFF_HI, Z_MATCH_EXT, Z_COPY, Z_ERROR
+} z_state_t;
+
+typedef struct {
+    z_state_t state;
+    bool ext_match;
+    size_t lit;
+    size_t mlen;
+    uint16_t off;
+    char* dst;
+    size_t cap;
+    size_t len;
+} z_stream_t;
+
+// Framer throughput counters
+static usb_sync_stats_t g_stats;
+
+// RX ring between the USB RX task (producer) and the parser task (consumer)
+static char g_rx_ring[USB_SYNC_RX_RING_SIZE];
+static uint32_t g_rx_head = 0;               // Written by producer only
+static uint32_t g_rx_tail = 0;               // Written by consumer only
+static volatile uint32_t g_rx_stamp_us = 0;  // Arrival time of oldest unread byte
+static uint32_t g_dispatch_stamp_us = 0;     // Arrival time of the batch being parsed
+static const char* g_command_end = NULL;     // One past the command being dispatched
+static TaskHandle_t g_rx_task = NULL;
+static TaskHandle_t g_parser_task = NULL;
 
-// Pending notes queue
-static usb_sync_note_t g_pending_notes[USB_SYNC_MAX_PENDING_NOTES];
-static uint8_t g_note_count = 0;
+// Command dispatch table (open addressing, keyed by verb hash)
+typedef struct {
+    const char* verb;
+    size_t len;
+    usb_sync_handler_t handler;
+    const usb_sync_stream_t* stream;  // Set for streaming verbs instead of handler
+    uint32_t calls;
+    uint32_t lat_total_us;  // Receive-to-handled latency
+    uint32_t lat_max_us;
+} command_entry_t;
+static command_entry_t g_commands[USB_SYNC_MAX_COMMANDS];
+
+// Streaming text line in progress (payload bypasses the line buffer)
+static command_entry_t* g_stream = NULL;
+static long g_stream_id = -1;             // Request id, -1 if untagged
+static uint32_t g_stream_stamp_us = 0;
+static bool g_line_checked = false;       // Partial line already looked up
+
+// Pending notes queue - a ring of fixed-size slots in LittleFS. Note ids
+// increase forever; id N lives in slot N % USB_SYNC_NOTE_SLOTS.
+#define NOTE_RING_FILE "/notes.bin"
+#define NOTE_RESEND_MS 5000
+
+#if USB_SYNC_NOTE_WINDOW > 32
+#error "USB_SYNC_NOTE_WINDOW must fit the 32-bit ack bitmap"
+#endif
+
+#define NOTE_SLOT_EMPTY   0
+#define NOTE_SLOT_PENDING 1
+#define NOTE_SLOT_ACKED   2
+
+typedef struct {
+    uint32_t id;            // 0 = never written
+    uint8_t state;          // NOTE_SLOT_*
+    uint8_t reserved[3];
+    usb_sync_note_t note;
+} note_slot_t;
+
+static uint32_t g_note_head = 1;    // Oldest unacknowledged id
+static uint32_t g_note_tail = 1;    // Next id to assign
+static uint32_t g_note_sent = 1;    // Ids below this were sent this round
+static uint32_t g_note_acked = 0;   // Acked out of order, bit n = id g_note_head + n
+static unsigned long g_note_sent_ms = 0;
+static bool g_notes_ready = false;  // Ring file usable
+static SemaphoreHandle_t g_notes_mux = NULL;  // Queue is touched by UI and parser tasks
+
+// Serial TX: parser, UI and logging tasks all write lines to the link
+static SemaphoreHandle_t g_tx_mux = NULL;
 
 // Connection state
 static bool g_connected = false;
@@ -33,142 +132,674 @@ static unsigned long g_last_ping_time = 0;
 #define CONNECTION_TIMEOUT_MS 15000
 
 // Forward declarations
-static void handle_command(const char* command);
-static void handle_time_command(const char* payload);
-static void handle_ping(void);
-static void handle_get_logs(void);
-static void send_ready(void);
+static void handle_command(const char* command, size_t len);
+static void handle_time(const char* payload);
+static void handle_ping(const char* payload);
+static void handle_get_logs(const char* payload);
+static void handle_ok(const char* payload);
+static void handle_note_ack(const char* payload);
+static void note_ring_load(void);
+static void handle_stats(const char* payload);
+static void handle_cmd_stats(const char* payload);
+static void handle_framed(const char* payload);
+static void handle_compressed(const char* payload);
+static void handle_batch(const char* payload);
+static void handle_encodings(const char* payload);
+static char* alloc_command_buffer(void);
+static void handle_frame(uint8_t* raw, size_t len);
+static void usb_rx_task(void *arg);
+static void usb_parser_task(void *arg);
+static void handle_hello(const char* payload);
+static command_entry_t* find_command(const char* verb, size_t len);
+static void record_latency(command_entry_t* entry, uint32_t stamp_us);
 static void send_pending_notes(void);
-static void handle_jira_projects(const char* json_payload);
-static void handle_jira_log_ok(void);
+static void handle_jira_log_ok(const char* payload);
 static void handle_jira_log_error(const char* message);
 
-// jira_update_log_status and jira_update_projects_ui declared in lcd_bsp.h
+// Minutes of the timer or meeting worklog the Mac is handling (0 = none or
+// unknown) - counted towards today's hours when JIRA_LOG_OK arrives
+static volatile uint16_t g_worklog_min = 0;
+// Most minutes one JIRA_LOG_OK may add - a worklog never exceeds a day
+#define WORKLOG_MAX_MIN (24 * 60)
+
+// jira_update_log_status declared in lcd_bsp.h
 
 // Initialize USB sync module
 void usb_sync_init(void) {
-    Serial.println("USBSync: Initialized");
+    g_tx_mux = xSemaphoreCreateRecursiveMutex();
+    LOGI("Initialized");
     g_buffer_index = 0;
-    g_note_count = 0;
+    g_discarding = false;
+    g_in_frame = false;
+    g_stream = NULL;
     g_connected = false;
-    memset(g_serial_buffer, 0, sizeof(g_serial_buffer));
-    memset(g_pending_notes, 0, sizeof(g_pending_notes));
+    memset(&g_stats, 0, sizeof(g_stats));
+    g_notes_mux = xSemaphoreCreateMutex();
+    note_ring_load();  // LittleFS is mounted by time_log_init()
+
+    // Built-in commands; data modules register their own in *_init(),
+    // which must run before this so no command arrives unregistered
+    usb_sync_register_command("HELLO", handle_hello);
+    usb_sync_register_command("PING", handle_ping);
+    usb_sync_register_command("TIME", handle_time);
+    usb_sync_register_command("GET_LOGS", handle_get_logs);
+    usb_sync_register_command("STATS", handle_stats);
+    usb_sync_register_command("CMD_STATS", handle_cmd_stats);
+    usb_sync_register_command("FRAMED", handle_framed);
+    usb_sync_register_command("Z", handle_compressed);
+    usb_sync_register_command("BATCH", handle_batch);
+    usb_sync_register_command("ENCODINGS", handle_encodings);
+    usb_sync_register_command("OK", handle_ok);
+    usb_sync_register_command("NOTE_ACK", handle_note_ack);
+    usb_sync_register_command("JIRA_LOG_OK", handle_jira_log_ok);
+    usb_sync_register_command("JIRA_LOG_ERROR", handle_jira_log_error);
+
+    // Parser first - the RX task notifies it
+    if (xTaskCreate(usb_parser_task, "usb_parser", USB_SYNC_PARSER_STACK, NULL, 3, &g_parser_task) == pdPASS) {
+        if (xTaskCreate(usb_rx_task, "usb_rx", 2048, NULL, 4, &g_rx_task) == pdPASS) {
+            LOGI("RX task started");
+            return;
+        }
+        vTaskDelete(g_parser_task);
+        g_parser_task = NULL;
+    }
+    LOGW("RX task failed, polling from loop()");
 }
 
-// Process incoming serial commands
-void usb_sync_process(void) {
-    // Check for connection timeout
-    if (g_connected && (millis() - g_last_ping_time > CONNECTION_TIMEOUT_MS)) {
-        g_connected = false;
-        Serial.println("USBSync: Connection timed out");
+// Switch to streaming if the partial text line [start, end) begins with
+// "[@<id> ]VERB:" for a streaming verb. The payload received so far is fed
+// at once; framer_feed() routes the rest of the line to the stream.
+static bool stream_start(const char* start, const char* end) {
+    if (g_discarding || g_line_checked) return false;
+
+    const char* colon = (const char*)memchr(start, ':', end - start);
+    if (!colon) return false;  // Verb incomplete - look again when more arrives
+    g_line_checked = true;
+
+    const char* verb = start;
+    long id = -1;
+    if (*verb == '@') {
+        char* sp;
+        id = (long)strtoul(verb + 1, &sp, 10);
+        if (sp == verb + 1 || sp >= colon || *sp != ' ') return false;
+        verb = sp + 1;
     }
 
-    // Read available serial data
-    while (Serial.available()) {
-        char c = Serial.read();
+    command_entry_t* entry = find_command(verb, colon - verb);
+    if (!entry || !entry->stream) return false;
 
-        // End of command (newline)
-        if (c == '\n') {
-            g_serial_buffer[g_buffer_index] = '\0';
-            if (g_buffer_index > 0) {
-                handle_command(g_serial_buffer);
+    LOGD("Streaming command: %.*s", (int)(colon - verb), verb);
+    g_stream = entry;
+    g_stream_id = id;
+    g_stream_stamp_us = g_dispatch_stamp_us;
+    g_stats.rx_streams++;
+    g_stats.rx_stream_bytes += end - colon - 1;
+
+    entry->stream->begin();
+    if (end > colon + 1) entry->stream->feed(colon + 1, end - colon - 1);
+    return true;
+}
+
+// Route bytes of the streaming line to its handler up to the newline.
+// A zero byte starts a binary frame and abandons the line, as it does for
+// buffered text. Returns the bytes consumed.
+static size_t stream_feed(const char* data, size_t len) {
+    const char* nl = (const char*)memchr(data, '\n', len);
+    size_t n = nl ? (size_t)(nl - data) : len;
+    const char* z = (const char*)memchr(data, '\0', n);
+
+    if (z) n = z - data;
+    if (n > 0) {
+        g_stream->stream->feed(data, n);
+        g_stats.rx_stream_bytes += n;
+    }
+    if (!z && !nl) return n;
+
+    // Line finished (or cut off) - the newline is consumed, a zero byte is not
+    command_entry_t* entry = g_stream;
+    g_stream = NULL;
+    g_line_checked = false;
+    entry->stream->end(z == NULL);
+    if (z) {
+        LOGW("Stream %s cut off by a frame", entry->verb);
+        return n;
+    }
+
+    g_stats.rx_lines++;
+    record_latency(entry, g_stream_stamp_us);
+    if (g_stream_id >= 0) usb_sync_printf("END:%ld\n", g_stream_id);
+    return n + 1;
+}
+
+// Dispatch every complete segment in g_serial_buffer[0..g_buffer_index) in place,
+// then slide the trailing partial segment (if any) to the front of the buffer.
+//
+// The stream carries two kinds of segment:
+//   text line:    <command>\n
+//   binary frame: 0x00 <COBS bytes> 0x00
+// Text never contains 0x00, so a zero byte always starts (or ends) a frame and
+// a partial text line in front of it is abandoned.
+static void frame_lines(uint16_t scan_from) {
+    char* start = g_serial_buffer;
+    char* end = g_serial_buffer + g_buffer_index;
+    char* scan = g_serial_buffer + scan_from;
+
+    while (scan < end) {
+        if (g_in_frame) {
+            char* z = (char*)memchr(scan, '\0', end - scan);
+            if (!z) break;
+            if (z > start) {
+                handle_frame((uint8_t*)start, z - start);
+                g_in_frame = false;
             }
-            g_buffer_index = 0;
-            memset(g_serial_buffer, 0, sizeof(g_serial_buffer));
+            // Back-to-back delimiters are an empty frame - stay in frame state
+            start = z + 1;
+            scan = start;
+            continue;
         }
-        // Ignore carriage return
-        else if (c == '\r') {
+
+        char* nl = (char*)memchr(scan, '\n', end - scan);
+        char* z = (char*)memchr(scan, '\0', (nl ? nl : end) - scan);
+        if (z) {
+            g_in_frame = true;
+            g_discarding = false;
+            g_line_checked = false;
+            start = z + 1;
+            scan = start;
             continue;
         }
-        // Add character to buffer
-        else if (g_buffer_index < USB_SYNC_BUFFER_SIZE - 1) {
-            g_serial_buffer[g_buffer_index++] = c;
+        if (!nl) {
+            // A streaming verb takes the rest of the line as it arrives
+            if (stream_start(start, end)) start = end;
+            break;
+        }
+
+        char* line_end = nl;
+        if (line_end > start && line_end[-1] == '\r') line_end--;
+        *line_end = '\0';
+
+        if (g_discarding) {
+            // Tail of an oversized line - the truncated head was already dispatched
+            g_discarding = false;
+        } else if (line_end > start) {
+            g_stats.rx_lines++;
+            handle_command(start, line_end - start);
         }
+        g_line_checked = false;
+        start = nl + 1;
+        scan = start;
     }
+
+    uint16_t remaining = end - start;
+    if (start != g_serial_buffer && remaining > 0) {
+        memmove(g_serial_buffer, start, remaining);
+    }
+    g_buffer_index = remaining;
 }
 
-// Handle a complete command
-static void handle_command(const char* command) {
-    Serial.printf("USBSync: Received command: %s\n", command);
+// CRC16-CCITT (poly 0x1021, init 0xFFFF) - matches Python binascii.crc_hqx(data, 0xFFFF)
+static uint16_t frame_crc16(const uint8_t* data, size_t len) {
+    uint16_t crc = 0xFFFF;
+    for (size_t i = 0; i < len; i++) {
+        crc ^= (uint16_t)data[i] << 8;
+        for (int b = 0; b < 8; b++) {
+            crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : (crc << 1);
+        }
+    }
+    return crc;
+}
+
+// Decode a COBS block in place (without delimiters). Returns decoded length, 0 on error.
+static size_t frame_cobs_decode(uint8_t* buf, size_t len) {
+    size_t in = 0, out = 0;
+    while (in < len) {
+        uint8_t code = buf[in++];
+        if (code == 0 || in + code - 1 > len) return 0;
+        for (uint8_t i = 1; i < code; i++) {
+            buf[out++] = buf[in++];
+        }
+        if (code != 0xFF && in < len) {
+            buf[out++] = 0;
+        }
+    }
+    return out;
+}
+
+// Reply with the fragments of the current message that have not arrived yet
+static void send_frame_nak(void) {
+    char buf[8 + USB_SYNC_FRAME_MAX_FRAGS * 3];
+    int n = snprintf(buf, sizeof(buf), "NAK:%u:", g_frame_seq);
+    bool first = true;
+    for (int i = 0; i <= g_frame_last; i++) {
+        if (!(g_frame_have & (1UL << i))) {
+            n += snprintf(buf + n, sizeof(buf) - n, first ? "%d" : ",%d", i);
+            first = false;
+        }
+    }
+    usb_sync_printf("%s\n", buf);
+}
+
+// Handle one binary frame (COBS-encoded, delimiters stripped).
+// Decoded layout: [type][msg seq][fragment][data...][crc16 hi][crc16 lo]
+//   type 'D' = fragment with more to follow (data is exactly USB_SYNC_FRAME_DATA bytes)
+//   type 'E' = final fragment of the message
+// Fragments land at fragment * USB_SYNC_FRAME_DATA in the reassembly buffer, so
+// out-of-order and retransmitted fragments need no extra RAM.
+static void handle_frame(uint8_t* raw, size_t len) {
+    size_t n = frame_cobs_decode(raw, len);
+    if (n < 5) {
+        g_stats.rx_bad_frames++;
+        return;
+    }
+
+    uint16_t crc = ((uint16_t)raw[n - 2] << 8) | raw[n - 1];
+    if (frame_crc16(raw, n - 2) != crc) {
+        g_stats.rx_bad_frames++;
+        return;
+    }
+
+    uint8_t type = raw[0];
+    uint8_t seq = raw[1];
+    uint8_t frag = raw[2];
+    const uint8_t* data = raw + 3;
+    size_t dlen = n - 5;
+
+    if (!g_frame_asm || (type != 'D' && type != 'E') || frag >= USB_SYNC_FRAME_MAX_FRAGS) {
+        g_stats.rx_bad_frames++;
+        return;
+    }
+    g_stats.rx_frames++;
+
+    // Retransmit of a message we already dispatched - the ACK was lost
+    if (seq == g_frame_done_seq) {
+        usb_sync_printf("ACK:%u\n", seq);
+        return;
+    }
 
-    // PING command
-    if (strcmp(command, "PING") == 0) {
-        handle_ping();
+    // First fragment of a new message
+    if (!g_frame_active || seq != g_frame_seq) {
+        g_frame_active = true;
+        g_frame_seq = seq;
+        g_frame_have = 0;
+        g_frame_last = -1;
+        g_frame_len = 0;
     }
-    // TIME command: TIME:YYYY-MM-DDTHH:MM:SS
-    else if (strncmp(command, "TIME:", 5) == 0) {
-        handle_time_command(command + 5);
+
+    size_t offset = (size_t)frag * USB_SYNC_FRAME_DATA;
+    if ((type == 'D' && dlen != USB_SYNC_FRAME_DATA) ||
+        offset + dlen > USB_SYNC_BUFFER_SIZE - 1) {
+        g_stats.rx_bad_frames++;
+        return;
     }
-    // GET_LOGS command
-    else if (strcmp(command, "GET_LOGS") == 0) {
-        handle_get_logs();
+
+    memcpy(g_frame_asm + offset, data, dlen);
+    g_frame_have |= (1UL << frag);
+    if (type == 'E') {
+        g_frame_last = frag;
+        g_frame_len = offset + dlen;
     }
-    // OK acknowledgment from computer
-    else if (strcmp(command, "OK") == 0) {
-        // Acknowledgment received - can remove sent items from queue
-        if (g_note_count > 0) {
-            // Remove first note from queue
-            memmove(&g_pending_notes[0], &g_pending_notes[1],
-                    sizeof(usb_sync_note_t) * (USB_SYNC_MAX_PENDING_NOTES - 1));
-            g_note_count--;
-            Serial.printf("USBSync: Note acknowledged, %d remaining\n", g_note_count);
+
+    if (g_frame_last < 0) return;
+
+    uint32_t want = (g_frame_last == 31) ? 0xFFFFFFFFUL : ((1UL << (g_frame_last + 1)) - 1);
+    if ((g_frame_have & want) != want) {
+        // Only the final fragment (or its retransmit) triggers a NAK
+        if (type == 'E') {
+            g_stats.rx_naks++;
+            send_frame_nak();
         }
+        return;
     }
-    // JIRA_PROJECTS:<json> - project list from Mac
-    else if (strncmp(command, "JIRA_PROJECTS:", 14) == 0) {
-        handle_jira_projects(command + 14);
+
+    // Message complete
+    g_frame_asm[g_frame_len] = '\0';
+    g_frame_active = false;
+    g_frame_done_seq = seq;
+    usb_sync_printf("ACK:%u\n", seq);
+
+    g_stats.rx_lines++;
+    handle_command(g_frame_asm, g_frame_len);
+}
+
+// Append bytes to the line buffer and dispatch every completed segment
+static void framer_feed(const char* data, size_t len) {
+    while (len > 0) {
+        if (g_stream) {
+            size_t used = stream_feed(data, len);
+            data += used;
+            len -= used;
+            continue;
+        }
+
+        uint16_t room = USB_SYNC_BUFFER_SIZE - 1 - g_buffer_index;
+
+        if (room == 0 && g_in_frame) {
+            // No valid frame is this large - drop it and resync on the next 0x00
+            g_stats.rx_bad_frames++;
+            g_in_frame = false;
+            g_buffer_index = 0;
+            room = USB_SYNC_BUFFER_SIZE - 1;
+        } else if (room == 0) {
+            // Line exceeds the buffer: dispatch the truncated head now and
+            // drop everything up to the next newline
+            g_serial_buffer[g_buffer_index] = '\0';
+            if (!g_discarding) {
+                g_stats.rx_truncated++;
+                g_stats.rx_lines++;
+                handle_command(g_serial_buffer, g_buffer_index);
+                g_discarding = true;
+            }
+            g_buffer_index = 0;
+            room = USB_SYNC_BUFFER_SIZE - 1;
+        }
+
+        size_t n = len < room ? len : room;
+        memcpy(g_serial_buffer + g_buffer_index, data, n);
+        data += n;
+        len -= n;
+
+        uint16_t scan_from = g_buffer_index;
+        g_buffer_index += n;
+        frame_lines(scan_from);
     }
-    // JIRA_LOG_OK - worklog posted successfully
-    else if (strcmp(command, "JIRA_LOG_OK") == 0) {
-        handle_jira_log_ok();
+}
+
+// Producer side: move whatever the CDC FIFO holds into the RX ring in bulk.
+// Returns true if any bytes were added.
+static bool rx_ring_fill(void) {
+    bool added = false;
+    int avail;
+
+    while ((avail = Serial.available()) > 0) {
+        uint32_t head = g_rx_head;
+        uint32_t tail = __atomic_load_n(&g_rx_tail, __ATOMIC_ACQUIRE);
+        uint32_t space = USB_SYNC_RX_RING_SIZE - (head - tail);
+        if (space == 0) break;  // Parser is behind - leave the rest in the CDC FIFO
+
+        uint32_t pos = head & (USB_SYNC_RX_RING_SIZE - 1);
+        uint32_t contiguous = USB_SYNC_RX_RING_SIZE - pos;
+        size_t want = (size_t)avail;
+        if (want > space) want = space;
+        if (want > contiguous) want = contiguous;
+
+        size_t got = Serial.readBytes(g_rx_ring + pos, want);
+        if (got == 0) break;
+
+        // Stamp the arrival of the oldest unread byte for latency accounting
+        if (head == tail) {
+            g_rx_stamp_us = micros();
+        }
+        __atomic_store_n(&g_rx_head, head + got, __ATOMIC_RELEASE);
+
+        g_stats.rx_bytes += got;
+        g_stats.rx_reads++;
+        added = true;
     }
-    // JIRA_LOG_ERROR:<message>
-    else if (strncmp(command, "JIRA_LOG_ERROR:", 15) == 0) {
-        handle_jira_log_error(command + 15);
+    return added;
+}
+
+// Consumer side: frame and dispatch everything currently in the RX ring
+static void rx_ring_drain(void) {
+    uint32_t head = __atomic_load_n(&g_rx_head, __ATOMIC_ACQUIRE);
+    uint32_t tail = g_rx_tail;
+    if (head == tail) return;
+
+    uint32_t t0 = micros();
+    g_dispatch_stamp_us = g_rx_stamp_us;
+
+    while (tail != head) {
+        uint32_t pos = tail & (USB_SYNC_RX_RING_SIZE - 1);
+        uint32_t n = head - tail;
+        if (n > USB_SYNC_RX_RING_SIZE - pos) n = USB_SYNC_RX_RING_SIZE - pos;
+
+        framer_feed(g_rx_ring + pos, n);
+        tail += n;
+        __atomic_store_n(&g_rx_tail, tail, __ATOMIC_RELEASE);
     }
-    // WEATHER:<json> - weather data from Mac
-    else if (strncmp(command, "WEATHER:", 8) == 0) {
-        weather_data_set(command + 8);
-        Serial.println("WEATHER_OK");
-        weather_update_ui();
+
+    g_stats.busy_us += micros() - t0;
+}
+
+static void check_connection_timeout(void) {
+    if (g_connected && (millis() - g_last_ping_time > CONNECTION_TIMEOUT_MS)) {
+        g_connected = false;
+        LOGW("Connection timed out");
+    }
+}
+
+// USB RX task: owns CDC reception and wakes the parser when bytes arrive
+static void usb_rx_task(void *arg) {
+    for (;;) {
+        if (rx_ring_fill()) {
+            xTaskNotifyGive(g_parser_task);
+        } else {
+            vTaskDelay(1);
+        }
     }
-    // CALENDAR:<json> - calendar data from Mac
-    else if (strncmp(command, "CALENDAR:", 9) == 0) {
-        calendar_data_set(command + 9);
-        Serial.println("CALENDAR_OK");
-        calendar_update_ui();
+}
+
+// USB parser task: frames and dispatches commands independent of loop()
+static void usb_parser_task(void *arg) {
+    for (;;) {
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(100));
+        rx_ring_drain();
+        check_connection_timeout();
+        warm_start_poll();
     }
-    // JIRA_HOURS:<json> - daily hours from Mac
-    else if (strncmp(command, "JIRA_HOURS:", 11) == 0) {
-        jira_hours_data_set(command + 11);
-        Serial.println("JIRA_HOURS_OK");
-        jira_hours_update_ui();
+}
+
+// Process incoming serial commands
+// Only does work if the RX/parser tasks could not be created.
+void usb_sync_process(void) {
+    if (g_rx_task) return;
+
+    check_connection_timeout();
+    while (rx_ring_fill()) {
+        rx_ring_drain();
     }
+    warm_start_poll();
+}
+
+const usb_sync_stats_t* usb_sync_get_stats(void) {
+    return &g_stats;
+}
+
+uint32_t usb_sync_command_rx_us(void) {
+    return g_dispatch_stamp_us;
+}
+
+void usb_sync_tx_lock(void) {
+    if (g_tx_mux) xSemaphoreTakeRecursive(g_tx_mux, portMAX_DELAY);
+}
+
+void usb_sync_tx_unlock(void) {
+    if (g_tx_mux) xSemaphoreGiveRecursive(g_tx_mux);
+}
+
+// Format into a stack buffer (heap for long lines like HELLO and STATS)
+// and send it with one write
+void usb_sync_printf(const char* fmt, ...) {
+    char small[128];
+    char* line = small;
+
+    va_list args;
+    va_start(args, fmt);
+    int n = vsnprintf(small, sizeof(small), fmt, args);
+    va_end(args);
+    if (n < 0) return;
+
+    if ((size_t)n >= sizeof(small)) {
+        line = (char*)malloc(n + 1);
+        if (!line) return;
+        va_start(args, fmt);
+        vsnprintf(line, n + 1, fmt, args);
+        va_end(args);
+    }
+
+    usb_sync_tx_lock();
+    Serial.write((const uint8_t*)line, n);
+    usb_sync_tx_unlock();
+    if (line != small) free(line);
+}
+
+// FNV-1a over the command verb
+static uint32_t command_hash(const char* verb, size_t len) {
+    uint32_t h = 2166136261UL;
+    for (size_t i = 0; i < len; i++) {
+        h ^= (uint8_t)verb[i];
+        h *= 16777619UL;
+    }
+    return h;
+}
+
+// Add or replace a table entry; exactly one of handler/stream is set
+static bool register_entry(const char* verb, usb_sync_handler_t handler,
+                           const usb_sync_stream_t* stream) {
+    size_t len = strlen(verb);
+    uint32_t slot = command_hash(verb, len) & (USB_SYNC_MAX_COMMANDS - 1);
+
+    for (int probe = 0; probe < USB_SYNC_MAX_COMMANDS; probe++) {
+        command_entry_t* e = &g_commands[slot];
+        if (!e->verb || (e->len == len && memcmp(e->verb, verb, len) == 0)) {
+            e->verb = verb;
+            e->len = len;
+            e->handler = handler;
+            e->stream = stream;
+            return true;
+        }
+        slot = (slot + 1) & (USB_SYNC_MAX_COMMANDS - 1);
+    }
+
+    LOGW("Command table full, cannot register %s", verb);
+    return false;
+}
+
+// Register a handler for a command verb
+bool usb_sync_register_command(const char* verb, usb_sync_handler_t handler) {
+    return register_entry(verb, handler, NULL);
+}
+
+// Register a streaming command verb
+bool usb_sync_register_stream(const char* verb, const usb_sync_stream_t* stream) {
+    return register_entry(verb, NULL, stream);
+}
+
+// Look up the entry for a verb of len bytes
+static command_entry_t* find_command(const char* verb, size_t len) {
+    uint32_t slot = command_hash(verb, len) & (USB_SYNC_MAX_COMMANDS - 1);
+    for (int probe = 0; probe < USB_SYNC_MAX_COMMANDS; probe++) {
+        command_entry_t* e = &g_commands[slot];
+        if (!e->verb) break;
+        if (e->len == len && memcmp(e->verb, verb, len) == 0) return e;
+        slot = (slot + 1) & (USB_SYNC_MAX_COMMANDS - 1);
+    }
+    return NULL;
+}
+
+static void record_latency(command_entry_t* entry, uint32_t stamp_us) {
+    uint32_t lat = micros() - stamp_us;
+    entry->calls++;
+    entry->lat_total_us += lat;
+    if (lat > entry->lat_max_us) entry->lat_max_us = lat;
+}
+
+// Run the handler for one VERB[:payload] line
+static void dispatch_command(const char* command) {
+    const char* colon = strchr(command, ':');
+    size_t len = colon ? (size_t)(colon - command) : strlen(command);
+    const char* payload = colon ? colon + 1 : "";
+
+    command_entry_t* entry = find_command(command, len);
+    if (entry) {
+        if (entry->stream) {
+            // Already complete (frame, Z, BATCH or short line) - one piece
+            entry->stream->begin();
+            if (colon) entry->stream->feed(payload, g_command_end - payload);
+            entry->stream->end(true);
+        } else {
+            entry->handler(payload);
+        }
+        record_latency(entry, g_dispatch_stamp_us);
+        return;
+    }
+
     // Unknown command
-    else {
-        Serial.printf("USBSync: Unknown command: %s\n", command);
-        Serial.println("ERROR:Unknown command");
+    LOGW("Unknown command: %.40s", command);
+    usb_sync_printf("ERROR:Unknown command\n");
+}
+
+// Handle one command of len bytes (NUL-terminated; binary payloads may
+// contain NULs). "@<id> VERB:payload" tags the request: every reply line is
+// written by the handler before it returns, so END:<id> after it tells the
+// companion the response is complete.
+static void handle_command(const char* command, size_t len) {
+    LOGD("Received command: %.40s", command);  // Verb + head only, never the full payload
+
+    // Nested dispatch (Z, BATCH) restores the outer command's bounds
+    const char* outer_end = g_command_end;
+    g_command_end = command + len;
+
+    if (command[0] != '@') {
+        dispatch_command(command);
+    } else {
+        char* end;
+        unsigned long id = strtoul(command + 1, &end, 10);
+        if (end == command + 1 || *end != ' ') {
+            usb_sync_printf("ERROR:Invalid request id\n");
+        } else {
+            dispatch_command(end + 1);
+            usb_sync_printf("END:%lu\n", id);
+        }
     }
+    g_command_end = outer_end;
+}
+
+DeserializationError usb_sync_parse_payload(JsonDocument& doc, const char* payload) {
+    uint32_t t0 = micros();
+    DeserializationError err;
+
+    if (payload[0] != 'M') {
+        err = deserializeJson(doc, payload);
+        g_stats.parse_json_bytes += strlen(payload);
+        g_stats.parse_json_us += micros() - t0;
+        return err;
+    }
+
+    char* data;
+    unsigned long n = strtoul(payload + 1, &data, 10);
+    if (data == payload + 1 || *data != ':' || !g_command_end ||
+        data >= g_command_end || n > (size_t)(g_command_end - data - 1)) {
+        return DeserializationError::InvalidInput;
+    }
+    err = deserializeMsgPack(doc, (const uint8_t*)data + 1, n);
+    g_stats.parse_msgpack_bytes += n;
+    g_stats.parse_msgpack_us += micros() - t0;
+    return err;
 }
 
 // Handle PING command
-static void handle_ping(void) {
+static void handle_ping(const char* payload) {
     g_connected = true;
     g_last_ping_time = millis();
-    Serial.println("PONG");
+    usb_sync_printf("PONG\n");
 
-    // Send any pending notes
+    // Send any pending notes, resending ones whose ack never came
+    xSemaphoreTake(g_notes_mux, portMAX_DELAY);
+    if (g_note_sent > g_note_head && millis() - g_note_sent_ms > NOTE_RESEND_MS) {
+        g_note_sent = g_note_head;
+    }
     send_pending_notes();
+    xSemaphoreGive(g_notes_mux);
 }
 
 // Handle TIME command
-static void handle_time_command(const char* payload) {
+static void handle_time(const char* payload) {
     // Parse ISO8601 format: YYYY-MM-DDTHH:MM:SS
     int year, month, day, hour, minute, second;
 
     if (sscanf(payload, "%d-%d-%dT%d:%d:%d",
                &year, &month, &day, &hour, &minute, &second) != 6) {
-        Serial.println("ERROR:Invalid time format");
+        usb_sync_printf("ERROR:Invalid time format\n");
         return;
     }
 
@@ -186,63 +817,454 @@ static void handle_time_command(const char* payload) {
     struct timeval tv = { .tv_sec = t, .tv_usec = 0 };
 
     if (settimeofday(&tv, NULL) == 0) {
-        Serial.println("TIME_OK");
-        Serial.printf("USBSync: Time set to %04d-%02d-%02d %02d:%02d:%02d\n",
+        usb_sync_printf("TIME_OK\n");
+        LOGI("Time set to %04d-%02d-%02d %02d:%02d:%02d",
                      year, month, day, hour, minute, second);
     } else {
-        Serial.println("ERROR:Failed to set time");
+        usb_sync_printf("ERROR:Failed to set time\n");
     }
 }
 
+// Handle OK acknowledgment from computer - acknowledges a LOG: line.
+// Logs are re-sent in full by GET_LOGS, so there is no state to clear;
+// notes have their own NOTE_ACK.
+static void handle_ok(const char* payload) {
+}
+
 // Handle GET_LOGS command
-static void handle_get_logs(void) {
+static void handle_get_logs(const char* payload) {
     usb_sync_send_pending_logs();
 }
 
-// Send READY identification
-static void send_ready(void) {
-    Serial.println("READY:FocusKnob");
+// Handle STATS command
+// Reply: STATS:{"rx_bytes":N,"rx_reads":N,"rx_lines":N,"rx_truncated":N,
+//               "rx_frames":N,"rx_bad_frames":N,"rx_naks":N,"rx_z_bytes":N,
+//               "rx_z_raw_bytes":N,"busy_us":N,...,"rx_streams":N,"rx_stream_bytes":N,
+//               "arena_size":N,"arena_high_water":N,"arena_waits":N,"arena_failures":N}
+static void handle_stats(const char* payload) {
+    const json_arena_stats_t* arena = json_arena_get_stats();
+    usb_sync_printf("STATS:{\"rx_bytes\":%lu,\"rx_reads\":%lu,\"rx_lines\":%lu,"
+                    "\"rx_truncated\":%lu,\"rx_frames\":%lu,\"rx_bad_frames\":%lu,"
+                    "\"rx_naks\":%lu,\"rx_z_bytes\":%lu,\"rx_z_raw_bytes\":%lu,"
+                    "\"busy_us\":%lu,\"parse_json_bytes\":%lu,\"parse_json_us\":%lu,"
+                    "\"parse_msgpack_bytes\":%lu,\"parse_msgpack_us\":%lu,"
+                    "\"rx_streams\":%lu,\"rx_stream_bytes\":%lu,"
+                    "\"arena_size\":%lu,\"arena_high_water\":%lu,"
+                    "\"arena_waits\":%lu,\"arena_failures\":%lu}\n",
+                    (unsigned long)g_stats.rx_bytes, (unsigned long)g_stats.rx_reads,
+                    (unsigned long)g_stats.rx_lines, (unsigned long)g_stats.rx_truncated,
+                    (unsigned long)g_stats.rx_frames, (unsigned long)g_stats.rx_bad_frames,
+                    (unsigned long)g_stats.rx_naks, (unsigned long)g_stats.rx_z_bytes,
+                    (unsigned long)g_stats.rx_z_raw_bytes, (unsigned long)g_stats.busy_us,
+                    (unsigned long)g_stats.parse_json_bytes, (unsigned long)g_stats.parse_json_us,
+                    (unsigned long)g_stats.parse_msgpack_bytes, (unsigned long)g_stats.parse_msgpack_us,
+                    (unsigned long)g_stats.rx_streams, (unsigned long)g_stats.rx_stream_bytes,
+                    (unsigned long)arena->size, (unsigned long)arena->high_water,
+                    (unsigned long)arena->waits, (unsigned long)arena->failures);
+}
+
+// Handle CMD_STATS command
+// Reply: CMD_STATS:{"<VERB>":[calls,avg_us,max_us],...}
+static void handle_cmd_stats(const char* payload) {
+    usb_sync_tx_lock();
+    Serial.print("CMD_STATS:{");
+    bool first = true;
+    for (int i = 0; i < USB_SYNC_MAX_COMMANDS; i++) {
+        const command_entry_t* e = &g_commands[i];
+        if (!e->verb || e->calls == 0) continue;
+        Serial.printf("%s\"%s\":[%lu,%lu,%lu]", first ? "" : ",", e->verb,
+                      (unsigned long)e->calls,
+                      (unsigned long)(e->lat_total_us / e->calls),
+                      (unsigned long)e->lat_max_us);
+        first = false;
+    }
+    Serial.print("}\n");
+    usb_sync_tx_unlock();
+}
+
+// Allocate a USB_SYNC_BUFFER_SIZE command buffer, preferring PSRAM
+static char* alloc_command_buffer(void) {
+    char* buf = (char*)heap_caps_malloc(USB_SYNC_BUFFER_SIZE, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (!buf) {
+        buf = (char*)malloc(USB_SYNC_BUFFER_SIZE);
+    }
+    return buf;
+}
+
+// Feed one compressed byte to the streaming LZ4-block decoder.
+// Sequence: token(lit:4|match-4:4) [lit ext] literals offset(LE16) [match ext]
+static void z_feed(z_stream_t* z, uint8_t b) {
+    switch (z->state) {
+    case Z_TOKEN:
+        z->lit = b >> 4;
+        z->mlen = (b & 0x0F) + 4;
+        z->state = (z->lit == 15) ? Z_LIT_EXT : (z->lit ? Z_LITERALS : Z_OFF_LO);
+        z->ext_match = (b & 0x0F) == 15;
+        break;
+    case Z_LIT_EXT:
+        z->lit += b;
+        if (b != 255) z->state = Z_LITERALS;
+        break;
+    case Z_LITERALS:
+        if (z->len >= z->cap) { z->state = Z_ERROR; break; }
+        z->dst[z->len++] = (char)b;
+        if (--z->lit == 0) z->state = Z_OFF_LO;
+        break;
+    case Z_OFF_LO:
+        z->off = b;
+        z->state = Z_OFF_HI;
+        break;
+    case Z_OFF_HI:
+        z->off |= (uint16_t)b << 8;
+        if (z->off == 0 || z->off > z->len || z->off > USB_SYNC_Z_WINDOW) {
+            z->state = Z_ERROR;
+        } else if (z->ext_match) {
+            z->state = Z_MATCH_EXT;
+        } else {
+            z->state = Z_COPY;
+        }
+        break;
+    case Z_MATCH_EXT:
+        z->mlen += b;
+        if (b != 255) z->state = Z_COPY;
+        break;
+    default:
+        break;
+    }
+
+    if (z->state == Z_COPY) {
+        if (z->mlen > z->cap - z->len) {
+            z->state = Z_ERROR;
+            return;
+        }
+        // Byte-wise so overlapping matches (off < mlen) replicate correctly
+        for (size_t i = 0; i < z->mlen; i++, z->len++) {
+            z->dst[z->len] = z->dst[z->len - z->off];
+        }
+        z->state = Z_TOKEN;
+    }
+}
+
+// Decode base64 text straight into the LZ4 stream, 6 bits at a time
+static void z_feed_base64(z_stream_t* z, const char* b64) {
+    uint32_t acc = 0;
+    int bits = 0;
+    for (const char* p = b64; *p && *p != '=' && z->state != Z_ERROR; p++) {
+        char c = *p;
+        int v;
+        if (c >= 'A' && c <= 'Z')      v = c - 'A';
+        else if (c >= 'a' && c <= 'z') v = c - 'a' + 26;
+        else if (c >= '0' && c <= '9') v = c - '0' + 52;
+        else if (c == '+')             v = 62;
+        else if (c == '/')             v = 63;
+        else { z->state = Z_ERROR; break; }
+
+        acc = (acc << 6) | v;
+        bits += 6;
+        if (bits >= 8) {
+            bits -= 8;
+            z_feed(z, (uint8_t)(acc >> bits));
+        }
+    }
+}
+
+// Handle Z command - compressed envelope around any other command
+// Format: Z:<decompressed length>:<base64 LZ4 block>
+static void handle_compressed(const char* payload) {
+    static bool busy = false;
+    if (busy) {
+        usb_sync_printf("ERROR:Nested Z\n");
+        return;
+    }
+
+    char* sep;
+    unsigned long raw_len = strtoul(payload, &sep, 10);
+    if (*sep != ':' || raw_len == 0 || raw_len > USB_SYNC_BUFFER_SIZE - 1) {
+        usb_sync_printf("ERROR:Invalid Z header\n");
+        return;
+    }
+
+    if (!g_z_out) {
+        g_z_out = alloc_command_buffer();
+        if (!g_z_out) {
+            usb_sync_printf("ERROR:No memory for Z\n");
+            return;
+        }
+    }
+
+    z_stream_t z = {};
+    z.state = Z_TOKEN;
+    z.dst = g_z_out;
+    z.cap = raw_len;
+    z_feed_base64(&z, sep + 1);
+
+    // A block may only end after a sequence's literals
+    bool ended_cleanly = (z.state == Z_TOKEN || z.state == Z_OFF_LO);
+    if (!ended_cleanly || z.len != raw_len) {
+        g_stats.rx_bad_frames++;
+        usb_sync_printf("ERROR:Bad Z payload\n");
+        return;
+    }
+
+    g_z_out[z.len] = '\0';
+    g_stats.rx_z_bytes += strlen(sep + 1);
+    g_stats.rx_z_raw_bytes += z.len;
+
+    busy = true;
+    handle_command(g_z_out, z.len);
+    busy = false;
 }
 
-// Send pending notes to computer
+// End of the batch segment starting at p: the next separator, looking past
+// a binary "VERB:M<len>:" payload whose bytes may include the separator.
+// The marker is only looked for before the first separator, so a bare verb
+// ends there instead of borrowing the next segment's payload length.
+static char* batch_segment_end(char* p, char* end) {
+    char* scan = p;
+    char* first_sep = (char*)memchr(p, USB_SYNC_BATCH_SEP, end - p);
+    char* header_end = first_sep ? first_sep : end;
+    char* colon = (char*)memchr(p, ':', header_end - p);
+    if (colon && colon + 2 < end && colon[1] == 'M') {
+        char* data;
+        unsigned long n = strtoul(colon + 2, &data, 10);
+        if (data > colon + 2 && data < end && *data == ':' &&
+            n <= (size_t)(end - data - 1)) {
+            scan = data + 1 + n;
+        }
+    }
+    char* sep = (char*)memchr(scan, USB_SYNC_BATCH_SEP, end - scan);
+    return sep ? sep : end;
+}
+
+// Handle BATCH:<cmd><USB_SYNC_BATCH_SEP><cmd>...
+// Runs pipelined commands in order; each is normally "@<id> VERB:payload" so
+// its replies end at END:<id>. Sent as one framed/compressed message, a
+// whole connect-time sync costs a single transfer.
+static void handle_batch(const char* payload) {
+    static bool busy = false;
+    if (busy) {
+        usb_sync_printf("ERROR:Nested BATCH\n");
+        return;
+    }
+
+    // payload points into the parser's own command buffer, which stays
+    // untouched until this handler returns - split it in place
+    char* p = (char*)payload;
+    char* end = (char*)g_command_end;
+    busy = true;
+    while (p < end) {
+        char* seg_end = batch_segment_end(p, end);
+        *seg_end = '\0';
+        if (seg_end > p) handle_command(p, seg_end - p);
+        p = seg_end + 1;
+    }
+    busy = false;
+}
+
+// Handle ENCODINGS - data payload formats usb_sync_parse_payload() accepts
+static void handle_encodings(const char* payload) {
+    usb_sync_printf("ENCODINGS:JSON,MSGPACK\n");
+}
+
+// Handle FRAMED command
+// Enables COBS/CRC16 frames alongside text lines and resets sequence tracking.
+// Reply: FRAMED_OK:<fragment data size>
+static void handle_framed(const char* payload) {
+    if (!g_frame_asm) {
+        g_frame_asm = alloc_command_buffer();
+        if (!g_frame_asm) {
+            usb_sync_printf("ERROR:No memory for framed transport\n");
+            return;
+        }
+    }
+    g_frame_active = false;
+    g_frame_done_seq = -1;
+    usb_sync_printf("FRAMED_OK:%d\n", USB_SYNC_FRAME_DATA);
+}
+
+// Handle HELLO[:<host protocol version>] - capability handshake
+// Reply: HELLO:{"proto":N,"caps":[...],<compiled-in sizes>}
+// The companion picks every transport feature listed here instead of
+// probing for each one.
+static void handle_hello(const char* payload) {
+    usb_sync_printf("HELLO:{\"device\":\"FocusKnob\",\"proto\":%d,"
+                    "\"caps\":[\"REQID\",\"FRAMED\",\"Z\",\"BATCH\",\"MSGPACK\",\"TIMESYNC\",\"NOTE_ACK\",\"STREAM\",\"JIRA_PAGE\",\"SNAPSHOT\",\"LOG_MINUTES\"],"
+                    "\"buffer\":%d,\"frame_data\":%d,\"max_frags\":%d,\"rx_ring\":%d,"
+                    "\"z_window\":%d,\"note_window\":%d,\"jira_doc\":%d,\"snapshot\":\"%08lx\"}\n",
+                    USB_SYNC_PROTOCOL_VERSION,
+                    USB_SYNC_BUFFER_SIZE, USB_SYNC_FRAME_DATA, USB_SYNC_FRAME_MAX_FRAGS,
+                    USB_SYNC_RX_RING_SIZE, USB_SYNC_Z_WINDOW, USB_SYNC_NOTE_WINDOW, JIRA_DOC_SIZE,
+                    (unsigned long)warm_start_version());
+}
+
+// Read one ring slot (id and state only unless with_note)
+static bool note_slot_read(File& f, uint32_t slot, note_slot_t* out, bool with_note) {
+    size_t len = with_note ? sizeof(note_slot_t) : offsetof(note_slot_t, note);
+    if (!f.seek(slot * sizeof(note_slot_t))) return false;
+    return f.read((uint8_t*)out, len) == len;
+}
+
+// Open the ring and rebuild head/tail from the slot headers
+static void note_ring_load(void) {
+    g_notes_ready = false;
+    if (!LittleFS.exists(NOTE_RING_FILE)) {
+        // Preallocate every slot so later writes never grow the file
+        File f = LittleFS.open(NOTE_RING_FILE, "w");
+        if (!f) {
+            LOGE("Cannot create note ring");
+            return;
+        }
+        uint8_t zero[64] = {0};
+        for (size_t left = USB_SYNC_NOTE_SLOTS * sizeof(note_slot_t); left > 0; ) {
+            size_t n = left < sizeof(zero) ? left : sizeof(zero);
+            f.write(zero, n);
+            left -= n;
+        }
+        f.close();
+    }
+
+    File f = LittleFS.open(NOTE_RING_FILE, "r");
+    if (!f) {
+        LOGE("Cannot open note ring");
+        return;
+    }
+
+    uint32_t max_id = 0;
+    uint32_t min_pending = 0;
+    for (uint32_t i = 0; i < USB_SYNC_NOTE_SLOTS; i++) {
+        note_slot_t hdr;
+        if (!note_slot_read(f, i, &hdr, false) || hdr.id == 0) continue;
+        if (hdr.id > max_id) max_id = hdr.id;
+        if (hdr.state == NOTE_SLOT_PENDING && (min_pending == 0 || hdr.id < min_pending)) {
+            min_pending = hdr.id;
+        }
+    }
+
+    g_note_tail = max_id + 1;
+    g_note_head = min_pending ? min_pending : g_note_tail;
+    g_note_sent = g_note_head;
+    g_note_acked = 0;
+
+    // Acks received out of order before the reboot (always within one window)
+    for (uint32_t id = g_note_head; id < g_note_tail && id < g_note_head + 32; id++) {
+        note_slot_t hdr;
+        if (note_slot_read(f, id % USB_SYNC_NOTE_SLOTS, &hdr, false) &&
+            hdr.id == id && hdr.state == NOTE_SLOT_ACKED) {
+            g_note_acked |= 1UL << (id - g_note_head);
+        }
+    }
+    f.close();
+
+    g_notes_ready = true;
+    LOGI("Note ring: %lu pending", (unsigned long)(g_note_tail - g_note_head));
+}
+
+// Slide the window past every acknowledged note at its start
+static void note_ring_slide(void) {
+    while (g_note_head < g_note_sent && (g_note_acked & 1)) {
+        g_note_acked >>= 1;
+        g_note_head++;
+    }
+}
+
+// Send pending notes to computer - fills the in-flight window
+// Caller holds g_notes_mux
 static void send_pending_notes(void) {
-    for (int i = 0; i < g_note_count; i++) {
-        if (g_pending_notes[i].pending) {
-            StaticJsonDocument<512> doc;
-            doc["text"] = g_pending_notes[i].text;
-
-            char date_str[20];
-            snprintf(date_str, sizeof(date_str), "%04d-%02d-%02dT%02d:%02d:00",
-                    g_pending_notes[i].year, g_pending_notes[i].month,
-                    g_pending_notes[i].day, g_pending_notes[i].hour,
-                    g_pending_notes[i].minute);
-            doc["timestamp"] = date_str;
-
-            Serial.print("NOTE:");
-            serializeJson(doc, Serial);
-            Serial.println();
-
-            // Mark as sent (will be removed on OK acknowledgment)
-            g_pending_notes[i].pending = false;
-
-            // Only send one at a time, wait for OK
-            break;
+    if (!g_notes_ready) return;
+
+    uint32_t limit = g_note_head + USB_SYNC_NOTE_WINDOW;
+    if (limit > g_note_tail) limit = g_note_tail;
+    if (g_note_sent >= limit) return;
+
+    File f = LittleFS.open(NOTE_RING_FILE, "r");
+    if (!f) return;
+
+    for (; g_note_sent < limit; g_note_sent++) {
+        uint32_t id = g_note_sent;
+        if (g_note_acked & (1UL << (id - g_note_head))) continue;
+
+        note_slot_t slot;
+        if (!note_slot_read(f, id % USB_SYNC_NOTE_SLOTS, &slot, true) || slot.id != id) {
+            g_note_acked |= 1UL << (id - g_note_head);  // Slot lost - don't block the window
+            continue;
         }
+
+        StaticJsonDocument<512> doc;
+        doc["text"] = slot.note.text;
+
+        char date_str[20];
+        snprintf(date_str, sizeof(date_str), "%04d-%02d-%02dT%02d:%02d:00",
+                slot.note.year, slot.note.month, slot.note.day,
+                slot.note.hour, slot.note.minute);
+        doc["timestamp"] = date_str;
+
+        // Removed from the ring on NOTE_ACK:<id>
+        usb_sync_tx_lock();
+        Serial.printf("NOTE:%lu:", (unsigned long)id);
+        serializeJson(doc, Serial);
+        Serial.print("\n");
+        usb_sync_tx_unlock();
     }
+    f.close();
+    g_note_sent_ms = millis();
+    note_ring_slide();
+}
+
+// Mark one note acknowledged on flash and in the window
+// Caller holds g_notes_mux
+static void note_ring_ack(uint32_t id) {
+    if (id < g_note_head || id >= g_note_sent || id >= g_note_head + 32) return;
+
+    uint32_t bit = 1UL << (id - g_note_head);
+    if (g_note_acked & bit) return;
+
+    File f = LittleFS.open(NOTE_RING_FILE, "r+");
+    if (!f) return;
+    uint8_t state = NOTE_SLOT_ACKED;
+    f.seek((id % USB_SYNC_NOTE_SLOTS) * sizeof(note_slot_t) + offsetof(note_slot_t, state));
+    f.write(&state, 1);
+    f.close();
+
+    g_note_acked |= bit;
+}
+
+// Handle NOTE_ACK:<id>[,<id>...] - selective acknowledgement of sent notes
+static void handle_note_ack(const char* payload) {
+    xSemaphoreTake(g_notes_mux, portMAX_DELAY);
+    const char* p = payload;
+    while (*p) {
+        char* end;
+        unsigned long id = strtoul(p, &end, 10);
+        if (end == p) break;
+        note_ring_ack((uint32_t)id);
+        p = (*end == ',') ? end + 1 : end;
+    }
+
+    note_ring_slide();
+    LOGI("Notes acknowledged, %lu remaining", (unsigned long)(g_note_tail - g_note_head));
+
+    // Keep the window full - an offline burst drains in window-sized round trips
+    send_pending_notes();
+    xSemaphoreGive(g_notes_mux);
 }
 
 // Queue a note for Notion sync
 bool usb_sync_queue_note(const char* text) {
-    if (g_note_count >= USB_SYNC_MAX_PENDING_NOTES) {
-        Serial.println("USBSync: Note queue full!");
+    xSemaphoreTake(g_notes_mux, portMAX_DELAY);
+    if (!g_notes_ready || g_note_tail - g_note_head >= USB_SYNC_NOTE_SLOTS) {
+        xSemaphoreGive(g_notes_mux);
+        LOGW("Note queue full!");
         return false;
     }
 
-    usb_sync_note_t* note = &g_pending_notes[g_note_count];
+    note_slot_t slot;
+    memset(&slot, 0, sizeof(slot));
+    slot.id = g_note_tail;
+    slot.state = NOTE_SLOT_PENDING;
 
     // Copy text
-    strncpy(note->text, text, USB_SYNC_MAX_NOTE_LEN - 1);
-    note->text[USB_SYNC_MAX_NOTE_LEN - 1] = '\0';
+    strncpy(slot.note.text, text, USB_SYNC_MAX_NOTE_LEN - 1);
+    slot.note.text[USB_SYNC_MAX_NOTE_LEN - 1] = '\0';
 
     // Get current timestamp
     time_t now;
@@ -250,47 +1272,78 @@ bool usb_sync_queue_note(const char* text) {
     time(&now);
     localtime_r(&now, &timeinfo);
 
-    note->year = timeinfo.tm_year + 1900;
-    note->month = timeinfo.tm_mon + 1;
-    note->day = timeinfo.tm_mday;
-    note->hour = timeinfo.tm_hour;
-    note->minute = timeinfo.tm_min;
-    note->pending = true;
+    slot.note.year = timeinfo.tm_year + 1900;
+    slot.note.month = timeinfo.tm_mon + 1;
+    slot.note.day = timeinfo.tm_mday;
+    slot.note.hour = timeinfo.tm_hour;
+    slot.note.minute = timeinfo.tm_min;
+
+    // Persist before accepting - the note must survive a power cut
+    File f = LittleFS.open(NOTE_RING_FILE, "r+");
+    bool ok = f && f.seek((slot.id % USB_SYNC_NOTE_SLOTS) * sizeof(note_slot_t)) &&
+              f.write((const uint8_t*)&slot, sizeof(slot)) == sizeof(slot);
+    if (f) f.close();
+    if (!ok) {
+        xSemaphoreGive(g_notes_mux);
+        LOGE("Note write failed");
+        return false;
+    }
 
-    g_note_count++;
-    Serial.printf("USBSync: Note queued (%d pending)\n", g_note_count);
+    g_note_tail++;
+    LOGI("Note %lu queued (%lu pending)", (unsigned long)slot.id,
+         (unsigned long)(g_note_tail - g_note_head));
 
     // If connected, send immediately
     if (g_connected) {
         send_pending_notes();
     }
+    xSemaphoreGive(g_notes_mux);
 
     return true;
 }
 
+// Notes not yet acknowledged
+uint32_t usb_sync_pending_note_count(void) {
+    xSemaphoreTake(g_notes_mux, portMAX_DELAY);
+    uint32_t n = g_note_tail - g_note_head;
+    xSemaphoreGive(g_notes_mux);
+    return n;
+}
+
 // Check connection state
 bool usb_sync_is_connected(void) {
     return g_connected;
 }
 
-// Handle JIRA_PROJECTS command
-static void handle_jira_projects(const char* json_payload) {
-    jira_data_set_projects(json_payload);
-    Serial.println("JIRA_PROJECTS_OK");
-    // Refresh Jira UI if visible
-    jira_update_projects_ui();
-}
-
-// Handle JIRA_LOG_OK command
-static void handle_jira_log_ok(void) {
+// Handle JIRA_LOG_OK[:<minutes>] command
+// The minutes go on today's hours right away instead of waiting for the
+// next JIRA_HOURS; without them the in-flight request's duration is used.
+// Minutes that are not a plain number up to a day are not counted - the
+// next JIRA_HOURS brings the real total.
+static void handle_jira_log_ok(const char* payload) {
+    uint16_t minutes = g_worklog_min;
+    g_worklog_min = 0;
+    if (payload[0]) {
+        char* end;
+        unsigned long n = strtoul(payload, &end, 10);
+        if (payload[0] < '0' || payload[0] > '9' || *end != '\0' || n > WORKLOG_MAX_MIN) {
+            LOGW("Bad worklog minutes '%s'", payload);
+            n = 0;
+        }
+        minutes = (uint16_t)n;
+    }
     jira_update_log_status(true, "Logged to Jira!");
-    Serial.println("USBSync: Jira worklog confirmed");
+    bool changed = jira_hours_data_add_logged(minutes);
+    warm_start_note_update(DATA_TOPIC_JIRA_HOURS, changed);
+    if (changed) data_bus_publish(DATA_TOPIC_JIRA_HOURS);
+    LOGI("Jira worklog confirmed, %u min", minutes);
 }
 
 // Handle JIRA_LOG_ERROR command
 static void handle_jira_log_error(const char* message) {
+    g_worklog_min = 0;
     jira_update_log_status(false, message);
-    Serial.printf("USBSync: Jira worklog failed: %s\n", message);
+    LOGW("Jira worklog failed: %s", message);
 }
 
 // Send Jira timer completion notification
@@ -300,7 +1353,8 @@ static void handle_jira_log_error(const char* message) {
 void usb_sync_send_jira_timer_done(const char* project_key, uint16_t duration_minutes) {
     char buf[64];
     snprintf(buf, sizeof(buf), "JIRA_TIMER_DONE:%s|%u", project_key, duration_minutes);
-    Serial.println(buf);
+    g_worklog_min = duration_minutes;
+    usb_sync_printf("%s\n", buf);
 }
 
 // Send manual Jira time log request
@@ -308,21 +1362,27 @@ void usb_sync_send_jira_timer_done(const char* project_key, uint16_t duration_mi
 void usb_sync_send_jira_log_time(const char* issue_key) {
     char buf[64];
     snprintf(buf, sizeof(buf), "JIRA_LOG_TIME:%s", issue_key);
-    Serial.println(buf);
+    g_worklog_min = 0;  // Duration is entered on the Mac
+    usb_sync_printf("%s\n", buf);
 }
 
 // Send request to open Jira issue in browser on Mac
 void usb_sync_send_jira_open(const char* issue_key) {
     char buf[64];
     snprintf(buf, sizeof(buf), "JIRA_OPEN:%s", issue_key);
-    Serial.println(buf);
+    usb_sync_printf("%s\n", buf);
+}
+
+// Send Jira page request
+void usb_sync_send_jira_page(uint16_t offset) {
+    usb_sync_printf("JIRA_PAGE:%u\n", offset);
 }
 
 // Send pending time logs
 void usb_sync_send_pending_logs(void) {
     const daily_log_t* today = time_log_get_today();
     if (!today) {
-        Serial.println("LOG:{}");
+        usb_sync_printf("LOG:{}\n");
         return;
     }
 
@@ -363,9 +1423,11 @@ void usb_sync_send_pending_logs(void) {
         sessObj["duration"] = sess->duration_minutes;
     }
 
+    usb_sync_tx_lock();
     Serial.print("LOG:");
     serializeJson(doc, Serial);
-    Serial.println();
+    Serial.print("\n");
+    usb_sync_tx_unlock();
 }
 
 // Send calendar meeting log request to Mac
@@ -376,5 +1438,6 @@ void usb_sync_send_jira_log_meeting(const char* title, uint16_t duration_min) {
     strncpy(short_title, title, 63);
     short_title[63] = '\0';
     snprintf(buf, sizeof(buf), "JIRA_LOG_MEETING:%s|%u", short_title, duration_min);
-    Serial.println(buf);
+    g_worklog_min = duration_min;
+    usb_sync_printf("%s\n", buf);
 }
@@ -3,17 +3,37 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include <stddef.h>
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+// Sync protocol version announced by HELLO (bump on incompatible changes)
+#define USB_SYNC_PROTOCOL_VERSION 2
+
 // Maximum size for note text
 #define USB_SYNC_MAX_NOTE_LEN 256
-// Maximum pending notes in queue
-#define USB_SYNC_MAX_PENDING_NOTES 10
+// Persistent note queue: ring slots in LittleFS (no RAM per note)
+#define USB_SYNC_NOTE_SLOTS 64
+// Notes in flight before an acknowledgement is needed (<= 32)
+#define USB_SYNC_NOTE_WINDOW 8
 // Serial buffer size (large enough for JIRA_PROJECTS JSON with descriptions)
 #define USB_SYNC_BUFFER_SIZE 8192
+// Framed transport: payload bytes per fragment, fragments per message
+#define USB_SYNC_FRAME_DATA 256
+#define USB_SYNC_FRAME_MAX_FRAGS (USB_SYNC_BUFFER_SIZE / USB_SYNC_FRAME_DATA)
+// Z (compressed) envelope: max LZ4 match distance
+#define USB_SYNC_Z_WINDOW 4096
+// RX ring between the USB RX task and the parser task (power of two)
+#define USB_SYNC_RX_RING_SIZE 4096
+// Parser task stack - command handlers run here; large JSON documents come
+// from the shared arena (json_arena.h), not the stack
+#define USB_SYNC_PARSER_STACK 6144
+// Command dispatch table slots (power of two)
+#define USB_SYNC_MAX_COMMANDS 32
+// Separates the commands inside BATCH:<cmd><sep><cmd>... (never in JSON text)
+#define USB_SYNC_BATCH_SEP '\x1e'
 
 // Note entry for Notion sync
 typedef struct {
@@ -23,22 +43,83 @@ typedef struct {
     uint8_t day;
     uint8_t hour;
     uint8_t minute;
-    bool pending;
 } usb_sync_note_t;
 
+// Line framer throughput counters (cumulative since init)
+typedef struct {
+    uint32_t rx_bytes;      // Bytes drained from the CDC FIFO
+    uint32_t rx_reads;      // Bulk readBytes() calls
+    uint32_t rx_lines;      // Complete lines dispatched
+    uint32_t rx_truncated;  // Lines longer than USB_SYNC_BUFFER_SIZE - 1
+    uint32_t rx_frames;     // Valid binary frames
+    uint32_t rx_bad_frames; // Frames dropped (COBS/CRC/header error)
+    uint32_t rx_naks;       // Retransmit requests sent
+    uint32_t rx_z_bytes;    // Base64 bytes received in Z envelopes
+    uint32_t rx_z_raw_bytes;// Bytes after decompression
+    uint32_t busy_us;       // Time spent framing + dispatching
+    uint32_t parse_json_bytes;     // Data payloads parsed by usb_sync_parse_payload()
+    uint32_t parse_json_us;
+    uint32_t parse_msgpack_bytes;
+    uint32_t parse_msgpack_us;
+    uint32_t rx_streams;           // Streaming commands received as text lines
+    uint32_t rx_stream_bytes;      // Payload bytes fed to stream handlers
+} usb_sync_stats_t;
+
+// Command handler - payload is the text after "VERB:", or "" for a bare VERB
+typedef void (*usb_sync_handler_t)(const char* payload);
+
+// Streaming command - the payload is handed over in pieces as it arrives
+// instead of being buffered as one line, so a text line is not capped by
+// USB_SYNC_BUFFER_SIZE. Arriving in a frame, Z envelope or BATCH it is fed
+// in one piece. end(false) means the line was cut off by a binary frame.
+typedef struct {
+    void (*begin)(void);
+    void (*feed)(const char* data, size_t len);
+    void (*end)(bool complete);
+} usb_sync_stream_t;
+
 // Initialize USB sync module
 void usb_sync_init(void);
 
+// Register a handler for a command verb (the text before ':')
+// verb must stay valid for the lifetime of the program (string literal)
+// Returns false if the command table is full
+bool usb_sync_register_command(const char* verb, usb_sync_handler_t handler);
+
+// Register a streaming command verb; stream must stay valid (static)
+// Returns false if the command table is full
+bool usb_sync_register_stream(const char* verb, const usb_sync_stream_t* stream);
+
 // Process incoming serial commands - call from loop()
 void usb_sync_process(void);
 
 // Queue a note to be sent to Notion when USB is connected
+// The note is written to flash before this returns and survives reboot
 // Returns true if note was queued successfully
 bool usb_sync_queue_note(const char* text);
 
+// Notes written to flash and not yet acknowledged by the computer
+uint32_t usb_sync_pending_note_count(void);
+
 // Check if USB sync is currently connected/active
 bool usb_sync_is_connected(void);
 
+// Framer throughput counters (bytes/sec = rx_bytes / busy_us)
+const usb_sync_stats_t* usb_sync_get_stats(void);
+
+// micros() when the command being dispatched arrived over USB - lets
+// handlers timestamp a request without the parser queueing delay
+uint32_t usb_sync_command_rx_us(void);
+
+// Write one protocol line (fmt ends with \n) as a single write under the
+// TX lock. Every task shares the USB link, so no line goes out in pieces.
+void usb_sync_printf(const char* fmt, ...) __attribute__((format(printf, 1, 2)));
+
+// TX lock (recursive) for a line written in several prints; write nothing
+// but Serial output while holding it
+void usb_sync_tx_lock(void);
+void usb_sync_tx_unlock(void);
+
 // Send pending time logs via USB
 void usb_sync_send_pending_logs(void);
 
@@ -51,11 +132,23 @@ void usb_sync_send_jira_log_time(const char* issue_key);
 // Send request to open Jira issue in browser
 void usb_sync_send_jira_open(const char* issue_key);
 
+// Ask for the page of Jira issues starting at offset (reply: JIRA_PAGE_DATA)
+void usb_sync_send_jira_page(uint16_t offset);
+
 // Send calendar meeting log request to Mac
 void usb_sync_send_jira_log_meeting(const char* title, uint16_t duration_min);
 
 #ifdef __cplusplus
 }
+
+#include <ArduinoJson.h>
+
+// Parse a data command payload into doc. The payload is JSON text, or
+// "M<len>:" followed by <len> bytes of MessagePack - the companion only sends
+// that form inside frames or Z envelopes, which are binary-safe. Call it from
+// the running handler only: the MessagePack length is checked against the
+// command being dispatched.
+DeserializationError usb_sync_parse_payload(JsonDocument& doc, const char* payload);
 #endif
 
 #endif // USB_SYNC_H
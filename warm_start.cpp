@@ -0,0 +1,232 @@
+/*
+ * Warm start - binary snapshot of the companion data stores in flash
+ *
+ * File layout (native byte order, this firmware only):
+ *   warm_header_t
+ *   weather_state_t, calendar_state_t, jira_hours_state_t   (as in RAM)
+ *   Jira issue text: key, name, proj, status, desc per issue, each
+ *   NUL-terminated - read straight back into the string arena
+ * The version is FNV-1a over everything after the header. The file is
+ * written to a temporary name and renamed, so a reset mid-write leaves
+ * the previous snapshot in place.
+ */
+
+#define LOG_TAG "WarmStart"
+#include "warm_start.h"
+#include "debug_log.h"
+#include "usb_sync.h"
+#include "data_bus.h"
+#include "weather_data.h"
+#include "calendar_data.h"
+#include "jira_hours_data.h"
+#include "jira_data.h"
+#include <Arduino.h>
+#include <LittleFS.h>
+#include <string.h>
+
+typedef struct {
+    uint32_t magic;
+    uint16_t format;
+    uint16_t header_size;
+    uint32_t version;
+    // Struct sizes at save time - a rebuilt firmware with different
+    // layouts must not read the old bytes
+    uint16_t weather_size;
+    uint16_t calendar_size;
+    uint16_t hours_size;
+    uint16_t jira_count;
+    uint16_t jira_total;
+    uint16_t jira_version;
+    uint8_t jira_synced;
+    uint8_t reserved[3];
+    uint32_t jira_text_len;
+} warm_header_t;
+
+// Topics restored from flash and not yet confirmed by the companion
+static uint32_t g_stale = 0;
+// Unsaved changes, and when the last one arrived
+static bool g_dirty = false;
+static uint32_t g_changed_ms = 0;
+static uint32_t g_version = 0;
+
+// Staging for the fixed-size sections (off the parser task stack)
+static weather_state_t g_weather;
+static calendar_state_t g_calendar;
+static jira_hours_state_t g_hours;
+
+static void handle_snapshot_command(const char* payload);
+
+static uint32_t fnv_update(uint32_t h, const void* data, size_t len) {
+    const uint8_t* p = (const uint8_t*)data;
+    for (size_t i = 0; i < len; i++) {
+        h ^= p[i];
+        h *= 16777619UL;
+    }
+    return h;
+}
+
+static bool emit(File& f, const void* data, size_t len, uint32_t* hash) {
+    *hash = fnv_update(*hash, data, len);
+    return f.write((const uint8_t*)data, len) == len;
+}
+
+static bool load(void) {
+    if (!LittleFS.exists(WARM_START_FILE)) return false;
+    File f = LittleFS.open(WARM_START_FILE, "r");
+    if (!f) return false;
+
+    warm_header_t h;
+    if (f.read((uint8_t*)&h, sizeof(h)) != sizeof(h) ||
+        h.magic != WARM_START_MAGIC || h.format != WARM_START_FORMAT ||
+        h.header_size != sizeof(h) || h.weather_size != sizeof(weather_state_t) ||
+        h.calendar_size != sizeof(calendar_state_t) || h.hours_size != sizeof(jira_hours_state_t)) {
+        LOGW("Snapshot format changed, ignored");
+        f.close();
+        return false;
+    }
+
+    bool ok = f.read((uint8_t*)&g_weather, sizeof(g_weather)) == sizeof(g_weather) &&
+              f.read((uint8_t*)&g_calendar, sizeof(g_calendar)) == sizeof(g_calendar) &&
+              f.read((uint8_t*)&g_hours, sizeof(g_hours)) == sizeof(g_hours);
+
+    char* text = NULL;
+    if (ok && h.jira_text_len) {
+        text = jira_data_restore_text(h.jira_text_len);
+        ok = text && f.read((uint8_t*)text, h.jira_text_len) == h.jira_text_len;
+    }
+    f.close();
+
+    uint32_t hash = 2166136261UL;
+    hash = fnv_update(hash, &g_weather, sizeof(g_weather));
+    hash = fnv_update(hash, &g_calendar, sizeof(g_calendar));
+    hash = fnv_update(hash, &g_hours, sizeof(g_hours));
+    if (text) hash = fnv_update(hash, text, h.jira_text_len);
+    if (!ok || (hash ? hash : 1) != h.version) {
+        LOGW("Snapshot damaged, ignored");
+        return false;
+    }
+
+    if (h.jira_count &&
+        jira_data_restore(h.jira_count, h.jira_total, h.jira_version, h.jira_synced, h.jira_text_len)) {
+        g_stale |= DATA_TOPIC_JIRA;
+    }
+    weather_data_restore(&g_weather);
+    calendar_data_restore(&g_calendar);
+    jira_hours_data_restore(&g_hours);
+    if (g_weather.synced) g_stale |= DATA_TOPIC_WEATHER;
+    if (g_calendar.synced) g_stale |= DATA_TOPIC_CALENDAR;
+    if (g_hours.synced) g_stale |= DATA_TOPIC_JIRA_HOURS;
+
+    g_version = h.version;
+    LOGI("Restored %08lx: %u issues, %u text bytes", (unsigned long)g_version,
+         h.jira_count, (unsigned)h.jira_text_len);
+    return true;
+}
+
+static bool save(void) {
+    weather_data_snapshot(&g_weather);
+    calendar_data_snapshot(&g_calendar);
+    jira_hours_data_snapshot(&g_hours);
+
+    File f = LittleFS.open(WARM_START_TMP_FILE, "w");
+    if (!f) {
+        LOGE("Cannot create snapshot");
+        return false;
+    }
+
+    warm_header_t h;
+    memset(&h, 0, sizeof(h));
+    h.magic = WARM_START_MAGIC;
+    h.format = WARM_START_FORMAT;
+    h.header_size = sizeof(h);
+    h.weather_size = sizeof(weather_state_t);
+    h.calendar_size = sizeof(calendar_state_t);
+    h.hours_size = sizeof(jira_hours_state_t);
+    h.jira_count = jira_data_get_count();
+    h.jira_total = jira_data_get_total();
+    h.jira_version = jira_data_get_version();
+    h.jira_synced = jira_data_is_synced();
+
+    // Header again at the end, once version and text length are known
+    uint32_t hash = 2166136261UL;
+    bool ok = f.write((const uint8_t*)&h, sizeof(h)) == sizeof(h) &&
+              emit(f, &g_weather, sizeof(g_weather), &hash) &&
+              emit(f, &g_calendar, sizeof(g_calendar), &hash) &&
+              emit(f, &g_hours, sizeof(g_hours), &hash);
+
+    // The parser task is the only writer of the issue list, so the
+    // pointers are stable here
+    for (uint16_t i = 0; ok && i < h.jira_count; i++) {
+        const jira_project_t* p = jira_data_get_project(i);
+        const char* fields[] = { p->key, p->name, p->proj, p->status, p->desc };
+        for (size_t k = 0; ok && k < sizeof(fields) / sizeof(fields[0]); k++) {
+            size_t len = strlen(fields[k]) + 1;
+            ok = emit(f, fields[k], len, &hash);
+            h.jira_text_len += len;
+        }
+    }
+
+    h.version = hash ? hash : 1;  // 0 means "no snapshot"
+    ok = ok && f.seek(0) && f.write((const uint8_t*)&h, sizeof(h)) == sizeof(h);
+    f.close();
+
+    if (!ok || !LittleFS.rename(WARM_START_TMP_FILE, WARM_START_FILE)) {
+        LOGE("Snapshot write failed");
+        LittleFS.remove(WARM_START_TMP_FILE);
+        return false;
+    }
+    g_version = h.version;
+    LOGI("Saved %08lx: %u issues, %u text bytes", (unsigned long)g_version,
+         h.jira_count, (unsigned)h.jira_text_len);
+    return true;
+}
+
+void warm_start_init(void) {
+    uint32_t start = micros();
+    if (load()) {
+        LOGI("Warm start in %lu us", (unsigned long)(micros() - start));
+    }
+    usb_sync_register_command("SNAPSHOT", handle_snapshot_command);
+}
+
+void warm_start_note_update(uint32_t topic, bool changed) {
+    if (g_stale & topic) {
+        g_stale &= ~topic;
+        data_bus_publish(topic);  // Redraw without the stale marker
+    }
+    if (changed) {
+        g_dirty = true;
+        g_changed_ms = millis();
+    }
+}
+
+void warm_start_poll(void) {
+    if (!g_dirty || millis() - g_changed_ms < WARM_START_DEBOUNCE_MS) return;
+    g_dirty = false;
+    if (!save()) g_version = 0;
+}
+
+uint32_t warm_start_version(void) {
+    return g_dirty ? 0 : g_version;
+}
+
+bool warm_start_is_stale(uint32_t topic) {
+    return (g_stale & topic) != 0;
+}
+
+// SNAPSHOT[:<hex>] - see warm_start.h
+static void handle_snapshot_command(const char* payload) {
+    if (g_dirty) {
+        g_dirty = false;
+        if (!save()) g_version = 0;
+    }
+
+    if (payload && payload[0] && g_version &&
+        strtoul(payload, NULL, 16) == g_version) {
+        // The companion holds exactly this data - nothing is stale
+        uint32_t stale = g_stale;
+        g_stale = 0;
+        if (stale) data_bus_publish(stale);
+    }
+    usb_sync_printf("SNAPSHOT:%08lx\n", (unsigned long)g_version);
+}
@@ -0,0 +1,55 @@
+#ifndef WARM_START_H
+#define WARM_START_H
+
+/*
+ * Warm start - binary snapshot of the companion data stores in flash
+ *
+ * Weather, calendar, Jira hours and the loaded Jira issues are written to
+ * LittleFS a few seconds after they change and loaded straight back at
+ * boot, so the screens have data before the companion reconnects. Restored
+ * topics are "stale" until the companion sends or confirms fresh data.
+ *
+ * Each snapshot has a version (hash of its contents). HELLO reports it, and
+ * a companion that already knows that version skips the post-connect sync:
+ *   SNAPSHOT        -> save now if needed, reply SNAPSHOT:<version hex>
+ *   SNAPSHOT:<hex>  -> if <hex> is the current version, clear the stale
+ *                      markers; reply SNAPSHOT:<current version hex>
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define WARM_START_FILE "/warm.bin"
+#define WARM_START_TMP_FILE "/warm.tmp"
+#define WARM_START_MAGIC 0x53574B46u   // "FKWS"
+// Bump when a saved struct changes layout - older files are ignored
+#define WARM_START_FORMAT 1
+// Quiet time after the last change before the snapshot is written
+#define WARM_START_DEBOUNCE_MS 3000
+
+// Load the snapshot into the data stores and register SNAPSHOT.
+// Call after the data modules' init (LittleFS must be mounted).
+void warm_start_init(void);
+
+// A data store took an update from the companion (DATA_TOPIC_* bit).
+// Clears its stale marker; changed schedules a save.
+void warm_start_note_update(uint32_t topic, bool changed);
+
+// Write the snapshot once changes have settled - call from the parser task
+void warm_start_poll(void);
+
+// Version of the saved snapshot, 0 if there are unsaved changes or none
+uint32_t warm_start_version(void);
+
+// True while topic shows data restored from flash, not yet confirmed
+bool warm_start_is_stale(uint32_t topic);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // WARM_START_H
@@ -1,51 +1,69 @@
+#define LOG_TAG "WeatherData"
 #include "weather_data.h"
+#include "debug_log.h"
+#include "usb_sync.h"
+#include "json_arena.h"
+#include "snapshot.h"
+#include "data_bus.h"
+#include "warm_start.h"
 #include <Arduino.h>
 #include <ArduinoJson.h>
 #include <string.h>
 
-static weather_state_t g_weather_state;
+// Double-buffered so the LVGL task never sees a half-written update
+static weather_state_t g_weather_buf[2];
+static snapshot_t g_weather_snap = SNAPSHOT_INITIALIZER(&g_weather_buf[0], &g_weather_buf[1]);
+
+static const weather_state_t* weather_live(void) {
+    return (const weather_state_t*)snapshot_live(&g_weather_snap);
+}
+
+static void handle_weather_command(const char* payload);
 
 void weather_data_init(void) {
-    memset(&g_weather_state, 0, sizeof(g_weather_state));
-    g_weather_state.synced = false;
-    Serial.println("WeatherData: Initialized");
+    snapshot_init(&g_weather_snap, &g_weather_buf[0], &g_weather_buf[1], sizeof(weather_state_t));
+    LOGI("Initialized");
+
+    usb_sync_register_command("WEATHER", handle_weather_command);
 }
 
-void weather_data_set(const char* json) {
-    StaticJsonDocument<4096> doc;
-    DeserializationError err = deserializeJson(doc, json);
+bool weather_data_set(const char* json) {
+    ArenaJsonDocument doc(4096);
+    DeserializationError err = usb_sync_parse_payload(doc, json);
 
     if (err) {
-        Serial.printf("WeatherData: JSON parse error: %s\n", err.c_str());
-        return;
+        LOGW("JSON parse error: %s", err.c_str());
+        return false;
     }
 
+    weather_state_t* ws = (weather_state_t*)snapshot_begin_write(&g_weather_snap);
+
     // Parse current weather
     JsonObject current = doc["current"];
-    g_weather_state.current.temp = (int16_t)current["temp"].as<float>();
-    g_weather_state.current.temp_min = (int16_t)current["temp_min"].as<float>();
-    g_weather_state.current.temp_max = (int16_t)current["temp_max"].as<float>();
-    g_weather_state.current.humidity = current["humidity"] | 0;
-    g_weather_state.current.wind_speed = current["wind_speed"] | 0;
-    g_weather_state.current.condition_id = current["condition_id"] | 800;
+    ws->current.temp = (int16_t)current["temp"].as<float>();
+    ws->current.temp_min = (int16_t)current["temp_min"].as<float>();
+    ws->current.temp_max = (int16_t)current["temp_max"].as<float>();
+    ws->current.humidity = current["humidity"] | 0;
+    ws->current.wind_speed = current["wind_speed"] | 0;
+    ws->current.condition_id = current["condition_id"] | 800;
 
     const char* condition = current["condition"] | "Unknown";
-    strncpy(g_weather_state.current.condition, condition, WEATHER_CONDITION_LEN - 1);
-    g_weather_state.current.condition[WEATHER_CONDITION_LEN - 1] = '\0';
+    strncpy(ws->current.condition, condition, WEATHER_CONDITION_LEN - 1);
+    ws->current.condition[WEATHER_CONDITION_LEN - 1] = '\0';
 
     const char* desc = current["description"] | "";
-    strncpy(g_weather_state.current.description, desc, WEATHER_DESC_LEN - 1);
-    g_weather_state.current.description[WEATHER_DESC_LEN - 1] = '\0';
+    strncpy(ws->current.description, desc, WEATHER_DESC_LEN - 1);
+    ws->current.description[WEATHER_DESC_LEN - 1] = '\0';
 
     // Parse forecast array
     JsonArray forecast_arr = doc["forecast"];
-    g_weather_state.forecast_count = 0;
+    ws->forecast_count = 0;
 
     if (!forecast_arr.isNull()) {
         for (JsonObject entry : forecast_arr) {
-            if (g_weather_state.forecast_count >= WEATHER_MAX_FORECAST) break;
+            if (ws->forecast_count >= WEATHER_MAX_FORECAST) break;
 
-            weather_forecast_t *f = &g_weather_state.forecast[g_weather_state.forecast_count];
+            weather_forecast_t *f = &ws->forecast[ws->forecast_count];
             f->temp = (int16_t)entry["temp"].as<float>();
             f->condition_id = entry["condition_id"] | 800;
 
@@ -57,29 +75,50 @@ void weather_data_set(const char* json) {
             strncpy(f->description, fdesc, WEATHER_DESC_LEN - 1);
             f->description[WEATHER_DESC_LEN - 1] = '\0';
 
-            g_weather_state.forecast_count++;
+            ws->forecast_count++;
         }
     }
 
-    g_weather_state.synced = true;
+    ws->synced = true;
+    bool changed = snapshot_publish(&g_weather_snap);
 
-    Serial.printf("WeatherData: Updated, %d deg, %d forecast entries\n",
-                  g_weather_state.current.temp, g_weather_state.forecast_count);
+    LOGI("Updated, %d deg, %d forecast entries",
+                  ws->current.temp, ws->forecast_count);
+    return changed;
+}
+
+void weather_data_restore(const weather_state_t* saved) {
+    weather_state_t* ws = (weather_state_t*)snapshot_begin_write(&g_weather_snap);
+    memcpy(ws, saved, sizeof(*ws));
+    if (snapshot_publish(&g_weather_snap)) data_bus_publish(DATA_TOPIC_WEATHER);
+}
+
+void weather_data_snapshot(weather_state_t* out) {
+    snapshot_read(&g_weather_snap, out);
 }
 
 const weather_current_t* weather_data_get_current(void) {
-    return &g_weather_state.current;
+    return &weather_live()->current;
 }
 
 const weather_forecast_t* weather_data_get_forecast(uint8_t index) {
-    if (index >= g_weather_state.forecast_count) return NULL;
-    return &g_weather_state.forecast[index];
+    const weather_state_t* ws = weather_live();
+    if (index >= ws->forecast_count) return NULL;
+    return &ws->forecast[index];
 }
 
 uint8_t weather_data_get_forecast_count(void) {
-    return g_weather_state.forecast_count;
+    return weather_live()->forecast_count;
 }
 
 bool weather_data_is_synced(void) {
-    return g_weather_state.synced;
+    return weather_live()->synced;
+}
+
+// WEATHER:<json> - weather data from Mac
+static void handle_weather_command(const char* payload) {
+    bool changed = weather_data_set(payload);
+    usb_sync_printf("WEATHER_OK\n");
+    warm_start_note_update(DATA_TOPIC_WEATHER, changed);
+    if (changed) data_bus_publish(DATA_TOPIC_WEATHER);
 }
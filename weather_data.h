@@ -45,10 +45,16 @@ typedef struct {
 // Initialize weather data module
 void weather_data_init(void);
 
-// Parse weather JSON from Mac companion
-void weather_data_set(const char* json);
+// Parse weather JSON from Mac companion; true if the state changed
+bool weather_data_set(const char* json);
 
-// Getters
+// Install a state saved by warm_start
+void weather_data_restore(const weather_state_t* saved);
+
+// Consistent copy of the whole state - use this from the UI
+void weather_data_snapshot(weather_state_t* out);
+
+// Getters - point into the live buffer, valid until the next update
 const weather_current_t* weather_data_get_current(void);
 const weather_forecast_t* weather_data_get_forecast(uint8_t index);
 uint8_t weather_data_get_forecast_count(void);
@@ -1,4 +1,6 @@
+#define LOG_TAG "WiFiConfig"
 #include "wifi_config.h"
+#include "debug_log.h"
 #include <WiFi.h>
 #include <WebServer.h>
 #include <SPIFFS.h>
@@ -86,22 +88,22 @@ static bool load_config(void);
 static bool save_config(void);
 
 void wifi_config_init(void) {
-    Serial.println("WiFiConfig: Initializing...");
+    LOGI("Initializing...");
 
     // Load saved configuration
     if (load_config()) {
-        Serial.println("WiFiConfig: Loaded saved config");
-        Serial.printf("WiFiConfig: SSID: %s\n", g_ssid);
-        Serial.printf("WiFiConfig: Notion configured: %s\n", strlen(g_notion_key) > 0 ? "Yes" : "No");
+        LOGI("Loaded saved config");
+        LOGI("SSID: %s", g_ssid);
+        LOGI("Notion configured: %s", strlen(g_notion_key) > 0 ? "Yes" : "No");
     } else {
-        Serial.println("WiFiConfig: No saved config found");
+        LOGW("No saved config found");
     }
 
     g_wifi_state = WIFI_STATE_DISCONNECTED;
 }
 
 void wifi_config_start_ap(void) {
-    Serial.println("WiFiConfig: Starting AP mode...");
+    LOGI("Starting AP mode...");
 
     // Stop any existing connection
     WiFi.disconnect(true);
@@ -114,7 +116,7 @@ void wifi_config_start_ap(void) {
     IPAddress ip = WiFi.softAPIP();
     snprintf(g_ip_address, sizeof(g_ip_address), "%d.%d.%d.%d", ip[0], ip[1], ip[2], ip[3]);
 
-    Serial.printf("WiFiConfig: AP started - SSID: %s, IP: %s\n", AP_SSID, g_ip_address);
+    LOGI("AP started - SSID: %s, IP: %s", AP_SSID, g_ip_address);
 
     // Start web server
     if (g_server == nullptr) {
@@ -130,7 +132,7 @@ void wifi_config_start_ap(void) {
 
 void wifi_config_stop_ap(void) {
     if (g_ap_active) {
-        Serial.println("WiFiConfig: Stopping AP mode...");
+        LOGI("Stopping AP mode...");
         if (g_server != nullptr) {
             g_server->stop();
         }
@@ -141,11 +143,11 @@ void wifi_config_stop_ap(void) {
 
 bool wifi_config_connect(void) {
     if (strlen(g_ssid) == 0) {
-        Serial.println("WiFiConfig: No SSID configured");
+        LOGI("No SSID configured");
         return false;
     }
 
-    Serial.printf("WiFiConfig: Connecting to %s...\n", g_ssid);
+    LOGI("Connecting to %s...", g_ssid);
     g_wifi_state = WIFI_STATE_CONNECTING;
 
     // Stop AP if running
@@ -157,18 +159,16 @@ bool wifi_config_connect(void) {
     unsigned long start = millis();
     while (WiFi.status() != WL_CONNECTED && (millis() - start) < WIFI_CONNECT_TIMEOUT_MS) {
         delay(250);
-        Serial.print(".");
     }
-    Serial.println();
 
     if (WiFi.status() == WL_CONNECTED) {
         IPAddress ip = WiFi.localIP();
         snprintf(g_ip_address, sizeof(g_ip_address), "%d.%d.%d.%d", ip[0], ip[1], ip[2], ip[3]);
-        Serial.printf("WiFiConfig: Connected! IP: %s\n", g_ip_address);
+        LOGI("Connected! IP: %s", g_ip_address);
         g_wifi_state = WIFI_STATE_CONNECTED;
         return true;
     } else {
-        Serial.println("WiFiConfig: Connection failed");
+        LOGW("Connection failed");
         g_wifi_state = WIFI_STATE_DISCONNECTED;
         g_ip_address[0] = '\0';
         return false;
@@ -230,7 +230,7 @@ void wifi_config_clear_all(void) {
     }
 
     wifi_config_disconnect();
-    Serial.println("WiFiConfig: All credentials cleared");
+    LOGI("All credentials cleared");
 }
 
 void wifi_config_process(void) {
@@ -271,7 +271,7 @@ static void handle_save(void) {
         g_notion_db[sizeof(g_notion_db) - 1] = '\0';
     }
 
-    Serial.printf("WiFiConfig: Saving - SSID: %s\n", g_ssid);
+    LOGI("Saving - SSID: %s", g_ssid);
 
     // Save to file
     save_config();
@@ -301,7 +301,7 @@ static bool load_config(void) {
     file.close();
 
     if (error) {
-        Serial.printf("WiFiConfig: JSON parse error: %s\n", error.c_str());
+        LOGW("JSON parse error: %s", error.c_str());
         return false;
     }
 
@@ -329,13 +329,13 @@ static bool save_config(void) {
 
     File file = SPIFFS.open(CONFIG_FILE, "w");
     if (!file) {
-        Serial.println("WiFiConfig: Failed to open config file for writing");
+        LOGE("Failed to open config file for writing");
         return false;
     }
 
     serializeJson(doc, file);
     file.close();
 
-    Serial.println("WiFiConfig: Config saved");
+    LOGI("Config saved");
     return true;
 }